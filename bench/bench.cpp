@@ -0,0 +1,928 @@
+#define CATCH_CONFIG_RUNNER
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch2/catch.hpp"
+#define FMT_HEADER_ONLY
+#include "fmt/format.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <numeric>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "itertools/algorithm/all.hpp"
+#include "itertools/views/all.hpp"
+
+/*
+Benchmarks every view against an equivalent hand-written loop and, where C++20 has
+one, an equivalent std::ranges pipeline. Each benchmark is named
+"<view>/<variant>/<elements>", which the "json" reporter below splits back apart to
+report the time per element.
+
+The std:: adaptors are called rather than piped: itertools' operator| accepts any
+callable, and so is ambiguous with theirs.
+
+    bench --reporter json --out bench.json
+    bench --max-elements 1000000
+ */
+
+using namespace itertools;
+
+namespace {
+
+std::size_t max_elements = 100'000'000;
+
+std::vector<std::size_t>
+sizes()
+{
+    std::vector<std::size_t> ret;
+    for (std::size_t n : { 1'000, 1'000'000, 100'000'000 }) {
+        if (n <= max_elements) {
+            ret.push_back(n);
+        }
+    }
+    return ret;
+}
+
+std::vector<int>
+make_vector(std::size_t n, int start = 0)
+{
+    std::vector<int> v(n);
+    std::iota(v.begin(), v.end(), start);
+    return v;
+}
+
+/*
+Runs the three variants of one view at one size, one benchmark apiece. Each variant
+returns a checksum, so that the work can't be optimized away.
+ */
+template<class Itertools, class Loop, class Ranges>
+void
+bench_view(std::string_view view,
+           std::size_t n,
+           Itertools&& itertools_fn,
+           Loop&& loop_fn,
+           Ranges&& ranges_fn)
+{
+    BENCHMARK(fmt::format("{}/itertools/{}", view, n)) { return itertools_fn(); };
+    BENCHMARK(fmt::format("{}/loop/{}", view, n)) { return loop_fn(); };
+    BENCHMARK(fmt::format("{}/ranges/{}", view, n)) { return ranges_fn(); };
+}
+
+template<class Range>
+std::int64_t
+sum(Range&& range)
+{
+    std::int64_t total = 0;
+    for (auto&& x : range) {
+        total += x;
+    }
+    return total;
+}
+
+// An order-dependent checksum, for views where the order is the point.
+template<class Range>
+std::uint64_t
+hash(Range&& range)
+{
+    std::uint64_t h = 0;
+    for (auto&& x : range) {
+        h = h * 31 + static_cast<std::uint64_t>(x);
+    }
+    return h;
+}
+
+/*
+Writes one JSON object per benchmark:
+
+    { "view": ..., "variant": ..., "elements": ..., "mean_ns": ...,
+      "ns_per_element": ..., "stddev_ns": ..., "samples": ... }
+ */
+class json_reporter : public Catch::StreamingReporterBase<json_reporter>
+{
+  public:
+    using StreamingReporterBase::StreamingReporterBase;
+
+    static std::string getDescription()
+    {
+        return "Reports benchmark results as a JSON array";
+    }
+
+    void assertionStarting(Catch::AssertionInfo const&) override {}
+
+    bool assertionEnded(Catch::AssertionStats const&) override { return true; }
+
+    void testRunStarting(Catch::TestRunInfo const& info) override
+    {
+        StreamingReporterBase::testRunStarting(info);
+        stream << "[";
+    }
+
+    void benchmarkEnded(Catch::BenchmarkStats<> const& stats) override
+    {
+        std::string_view name = stats.info.name;
+        auto first = name.find('/');
+        auto last = name.rfind('/');
+
+        auto view = name.substr(0, first);
+        auto variant = name.substr(first + 1, last - first - 1);
+        auto elements = std::stod(std::string(name.substr(last + 1)));
+        auto mean = stats.mean.point.count();
+
+        stream << (count++ ? ",\n " : "\n ")
+               << fmt::format("{{ \"view\": \"{}\", \"variant\": \"{}\", "
+                              "\"elements\": {}, \"mean_ns\": {}, "
+                              "\"ns_per_element\": {}, \"stddev_ns\": {}, "
+                              "\"samples\": {} }}",
+                              view,
+                              variant,
+                              elements,
+                              mean,
+                              mean / elements,
+                              stats.standardDeviation.point.count(),
+                              stats.info.samples);
+    }
+
+    void testRunEnded(Catch::TestRunStats const& stats) override
+    {
+        stream << "\n]\n";
+        StreamingReporterBase::testRunEnded(stats);
+    }
+
+  private:
+    std::size_t count = 0;
+};
+
+CATCH_REGISTER_REPORTER("json", json_reporter)
+
+}
+
+TEST_CASE("zip", "[bench]")
+{
+    for (auto n : sizes()) {
+        auto a = make_vector(n);
+        auto b = make_vector(n, 7);
+
+        bench_view(
+          "zip",
+          n,
+          [&] {
+              std::int64_t total = 0;
+              for (auto&& [x, y] : views::zip(a, b)) {
+                  total += x * y;
+              }
+              return total;
+          },
+          [&] {
+              std::int64_t total = 0;
+              for (std::size_t i = 0; i < n; ++i) {
+                  total += a[i] * b[i];
+              }
+              return total;
+          },
+          [&] {
+              return sum(std::views::transform(std::views::iota(std::size_t{ 0 }, n),
+                                               [&](auto i) { return a[i] * b[i]; }));
+          });
+    }
+}
+
+TEST_CASE("zip_longest", "[bench]")
+{
+    for (auto n : sizes()) {
+        // A ragged pair: the second series stops halfway.
+        auto a = make_vector(n);
+        auto b = make_vector(n / 2, 7);
+
+        bench_view(
+          "zip_longest",
+          n,
+          [&] {
+              std::int64_t total = 0;
+              for (auto&& [x, y] : views::zip_longest(1, a, b)) {
+                  total += x * y;
+              }
+              return total;
+          },
+          [&] {
+              std::int64_t total = 0;
+              std::size_t i = 0;
+              for (; i < b.size(); ++i) {
+                  total += a[i] * b[i];
+              }
+              for (; i < n; ++i) {
+                  total += a[i];
+              }
+              return total;
+          },
+          [&] {
+              auto at = [&](auto i) { return a[i] * (i < b.size() ? b[i] : 1); };
+              auto ints = std::views::iota(std::size_t{ 0 }, n);
+              return sum(std::views::transform(ints, at));
+          });
+    }
+}
+
+TEST_CASE("enumerate", "[bench]")
+{
+    for (auto n : sizes()) {
+        auto a = make_vector(n);
+
+        bench_view(
+          "enumerate",
+          n,
+          [&] {
+              std::int64_t total = 0;
+              for (auto&& [i, x] : views::enumerate(a)) {
+                  total += i ^ x;
+              }
+              return total;
+          },
+          [&] {
+              std::int64_t total = 0;
+              for (std::size_t i = 0; i < n; ++i) {
+                  total += static_cast<int>(i) ^ a[i];
+              }
+              return total;
+          },
+          [&] {
+              return sum(
+                std::views::transform(std::views::iota(std::size_t{ 0 }, n),
+                                      [&](auto i) { return static_cast<int>(i) ^ a[i]; }));
+          });
+    }
+}
+
+TEST_CASE("filter", "[bench]")
+{
+    auto is_even = [](int x) { return x % 2 == 0; };
+
+    for (auto n : sizes()) {
+        auto a = make_vector(n);
+
+        bench_view(
+          "filter",
+          n,
+          [&] { return sum(a | views::filter(is_even)); },
+          [&] {
+              std::int64_t total = 0;
+              for (auto x : a) {
+                  if (is_even(x)) {
+                      total += x;
+                  }
+              }
+              return total;
+          },
+          [&] { return sum(std::views::filter(a, is_even)); });
+    }
+}
+
+TEST_CASE("transform", "[bench]")
+{
+    auto f = [](int x) { return x * 2 + 1; };
+
+    for (auto n : sizes()) {
+        auto a = make_vector(n);
+
+        bench_view(
+          "transform",
+          n,
+          [&] { return sum(a | views::transform(f)); },
+          [&] {
+              std::int64_t total = 0;
+              for (auto x : a) {
+                  total += f(x);
+              }
+              return total;
+          },
+          [&] { return sum(std::views::transform(a, f)); });
+    }
+}
+
+TEST_CASE("block", "[bench]")
+{
+    constexpr std::size_t block_size = 16;
+
+    for (auto n : sizes()) {
+        auto a = make_vector(n);
+
+        bench_view(
+          "block",
+          n,
+          [&] {
+              std::int64_t total = 0;
+              for (auto&& block : a | views::block(block_size)) {
+                  total += block.front() * static_cast<std::int64_t>(block.size());
+              }
+              return total;
+          },
+          [&] {
+              std::int64_t total = 0;
+              for (std::size_t i = 0; i < n; i += block_size) {
+                  auto size = std::min(block_size, n - i);
+                  total += a[i] * static_cast<std::int64_t>(size);
+              }
+              return total;
+          },
+          [&] {
+              auto blocks = (n + block_size - 1) / block_size;
+              return sum(std::views::transform(
+                std::views::iota(std::size_t{ 0 }, blocks), [&](auto k) {
+                    auto first = a.begin() + k * block_size;
+                    auto last = a.begin() + std::min(n, (k + 1) * block_size);
+                    auto block = std::ranges::subrange(first, last);
+                    return block.front() * static_cast<std::int64_t>(block.size());
+                }));
+          });
+    }
+}
+
+TEST_CASE("concat", "[bench]")
+{
+    for (auto n : sizes()) {
+        auto a = make_vector(n / 2);
+        auto b = make_vector(n - n / 2);
+
+        bench_view(
+          "concat",
+          n,
+          [&] { return hash(views::concat(a, b)); },
+          [&] {
+              std::uint64_t h = 0;
+              for (auto x : a) {
+                  h = h * 31 + static_cast<std::uint64_t>(x);
+              }
+              for (auto x : b) {
+                  h = h * 31 + static_cast<std::uint64_t>(x);
+              }
+              return h;
+          },
+          [&] {
+              auto ranges = std::array{ std::views::all(a), std::views::all(b) };
+              return hash(std::views::join(ranges));
+          });
+    }
+}
+
+TEST_CASE("flatten", "[bench]")
+{
+    constexpr std::size_t row_size = 1'000;
+
+    for (auto n : sizes()) {
+        std::vector<std::vector<int>> rows;
+        for (std::size_t i = 0; i < n; i += row_size) {
+            rows.push_back(make_vector(std::min(row_size, n - i)));
+        }
+
+        bench_view(
+          "flatten",
+          n,
+          [&] { return hash(views::flatten(rows)); },
+          [&] {
+              std::uint64_t h = 0;
+              for (auto&& row : rows) {
+                  for (auto x : row) {
+                      h = h * 31 + static_cast<std::uint64_t>(x);
+                  }
+              }
+              return h;
+          },
+          [&] { return hash(std::views::join(rows)); });
+    }
+}
+
+TEST_CASE("chain_from_iterable", "[bench]")
+{
+    // Merging per-thread results: many short vectors into one.
+    constexpr std::size_t part_size = 256;
+
+    for (auto n : sizes()) {
+        std::vector<std::vector<int>> parts;
+        for (std::size_t i = 0; i < n; i += part_size) {
+            parts.push_back(make_vector(std::min(part_size, n - i)));
+        }
+        auto checksum = [](const std::vector<int>& out) {
+            return out.size() + static_cast<std::size_t>(out.back());
+        };
+
+        bench_view(
+          "chain_from_iterable",
+          n,
+          [&] {
+              return checksum(views::chain_from_iterable(parts) |
+                              itertools::to<std::vector>());
+          },
+          [&] {
+              std::vector<int> out;
+              for (auto&& part : parts) {
+                  for (auto x : part) {
+                      out.push_back(x);
+                  }
+              }
+              return checksum(out);
+          },
+          [&] {
+              std::vector<int> out;
+              std::ranges::copy(std::views::join(parts), std::back_inserter(out));
+              return checksum(out);
+          });
+    }
+}
+
+TEST_CASE("reverse", "[bench]")
+{
+    for (auto n : sizes()) {
+        auto a = make_vector(n);
+
+        bench_view(
+          "reverse",
+          n,
+          [&] { return hash(a | views::reverse()); },
+          [&] {
+              std::uint64_t h = 0;
+              for (auto i = n; i-- > 0;) {
+                  h = h * 31 + static_cast<std::uint64_t>(a[i]);
+              }
+              return h;
+          },
+          [&] { return hash(std::views::reverse(a)); });
+    }
+}
+
+TEST_CASE("slice/stride", "[bench]")
+{
+    constexpr std::size_t stride = 3;
+
+    for (auto n : sizes()) {
+        auto a = make_vector(n);
+        auto start = n / 4;
+        auto stop = n - n / 4;
+
+        bench_view(
+          "slice_stride",
+          n,
+          [&] { return hash(a | views::slice(start, stop) | views::stride(stride)); },
+          [&] {
+              std::uint64_t h = 0;
+              for (auto i = start; i < stop; i += stride) {
+                  h = h * 31 + static_cast<std::uint64_t>(a[i]);
+              }
+              return h;
+          },
+          [&] {
+              // C++20 has no stride_view; step through indices instead.
+              auto count = (stop - start + stride - 1) / stride;
+              return hash(
+                std::views::transform(std::views::iota(std::size_t{ 0 }, count),
+                                      [&](auto k) { return a[start + k * stride]; }));
+          });
+    }
+}
+
+TEST_CASE("to", "[bench]")
+{
+    auto f = [](int x) { return x + 1; };
+
+    for (auto n : sizes()) {
+        auto a = make_vector(n);
+
+        bench_view(
+          "to",
+          n,
+          [&] { return (a | views::transform(f) | to<std::vector>()).size(); },
+          [&] {
+              std::vector<int> out;
+              for (auto x : a) {
+                  out.push_back(f(x));
+              }
+              return out.size();
+          },
+          [&] {
+              std::vector<int> out;
+              std::ranges::copy(std::views::transform(a, f), std::back_inserter(out));
+              return out.size();
+          });
+    }
+}
+
+TEST_CASE("repeat/cycle", "[bench]")
+{
+    // A padding byte, and a test pattern of a few dozen ints.
+    auto pattern = make_vector(37);
+
+    for (auto n : sizes()) {
+        bench_view(
+          "repeat",
+          n,
+          [&] { return (views::repeat(char(0x5a), n) | to<std::vector>()).size(); },
+          [&] {
+              std::vector<char> out;
+              for (std::size_t i = 0; i < n; ++i) {
+                  out.push_back(char(0x5a));
+              }
+              return out.size();
+          },
+          [&] {
+              std::vector<char> out;
+              auto bytes = std::views::transform(std::views::iota(std::size_t{ 0 }, n),
+                                                 [](auto) { return char(0x5a); });
+              std::ranges::copy(bytes, std::back_inserter(out));
+              return out.size();
+          });
+
+        // The fill is the work: the checksum only looks at the last element.
+        auto passes = n / pattern.size();
+        bench_view(
+          "cycle",
+          n,
+          [&] {
+              auto out = views::cycle(pattern, passes) | to<std::vector>();
+              return out.size() + out.back();
+          },
+          [&] {
+              std::vector<int> out;
+              for (std::size_t pass = 0; pass < passes; ++pass) {
+                  for (auto x : pattern) {
+                      out.push_back(x);
+                  }
+              }
+              return out.size() + out.back();
+          },
+          [&] {
+              std::vector<int> out;
+              auto at = [&](auto i) { return pattern[i % pattern.size()]; };
+              auto ints = std::views::iota(std::size_t{ 0 }, passes * pattern.size());
+              auto ints_at = std::views::transform(ints, at);
+              std::ranges::copy(ints_at, std::back_inserter(out));
+              return out.size() + out.back();
+          });
+    }
+}
+
+TEST_CASE("take_while/compress", "[bench]")
+{
+    for (auto n : sizes()) {
+        auto a = make_vector(n);
+        auto below = [n](int x) { return static_cast<std::size_t>(x) < n / 2; };
+
+        bench_view(
+          "take_while",
+          n,
+          [&] { return sum(a | views::take_while(below)); },
+          [&] {
+              std::int64_t total = 0;
+              for (auto x : a) {
+                  if (!below(x)) {
+                      break;
+                  }
+                  total += x;
+              }
+              return total;
+          },
+          [&] { return sum(std::views::take_while(a, below)); });
+
+        // Sparse selectors: one in 256 set, in runs a word long.
+        std::vector<bool> bits(n);
+        std::vector<char> bytes(n);
+        for (std::size_t i = 0; i < n; i += 256 * 64) {
+            for (std::size_t j = i; j < std::min(n, i + 64); ++j) {
+                bits[j] = true;
+                bytes[j] = 1;
+            }
+        }
+
+        bench_view(
+          "compress",
+          n,
+          [&] { return sum(views::compress(a, bits)); },
+          [&] {
+              std::int64_t total = 0;
+              for (std::size_t i = 0; i < n; ++i) {
+                  if (bits[i]) {
+                      total += a[i];
+                  }
+              }
+              return total;
+          },
+          [&] {
+              auto selected = [&](auto i) { return bytes[i] != 0; };
+              auto ints = std::views::iota(std::size_t{ 0 }, n);
+              auto at = [&](auto i) { return a[i]; };
+              return sum(
+                std::views::transform(std::views::filter(ints, selected), at));
+          });
+    }
+}
+
+TEST_CASE("csv", "[bench]")
+{
+    auto first_field = [](std::string_view row) {
+        int x = 0;
+        std::from_chars(row.data(), row.data() + row.size(), x);
+        return x;
+    };
+
+    for (auto n : sizes()) {
+        // A row is ~30 bytes; 1e8 of them would be more text than is reasonable.
+        if (n > 1'000'000) {
+            continue;
+        }
+
+        std::string text;
+        for (auto i : views::iota(n)) {
+            text += fmt::format("{},\"name, {}\",{}.5\n", i, i % 97, i);
+        }
+
+        bench_view(
+          "csv",
+          n,
+          [&] { return sum(text | views::csv<4>() | views::column<int>(0)); },
+          [&] {
+              // Quote-aware, a character at a time.
+              std::int64_t total = 0;
+              bool in_quote = false, row_start = true;
+              for (std::size_t i = 0; i < text.size(); ++i) {
+                  if (row_start) {
+                      total += first_field(std::string_view(text).substr(i));
+                      row_start = false;
+                  }
+                  if (text[i] == '"') {
+                      in_quote = !in_quote;
+                  } else if (text[i] == '\n' && !in_quote) {
+                      row_start = true;
+                  }
+              }
+              return total;
+          },
+          [&] {
+              // Unaware of quotes: rows are split at every newline.
+              std::int64_t total = 0;
+              for (auto&& row : std::views::split(text, '\n')) {
+                  total += first_field(std::string_view(row.begin(), row.end()));
+              }
+              return total;
+          });
+    }
+}
+
+TEST_CASE("bitpacked", "[bench]")
+{
+    for (auto n : sizes()) {
+        // Sorted timestamps, a few bits apart, delta encoded and bit-packed.
+        std::vector<std::uint64_t> timestamps(n);
+        std::uint64_t t = 1'700'000'000'000;
+        for (std::size_t i = 0; i < n; ++i) {
+            t += i % 37;
+            timestamps[i] = t;
+        }
+        auto packed = timestamps | views::delta() | views::to_bitpacked();
+
+        bench_view(
+          "bitpacked",
+          n,
+          [&] { return sum(views::unpack(packed) | views::undelta()); },
+          [&] {
+              // Uncompressed, from memory.
+              std::int64_t total = 0;
+              for (std::size_t i = 0; i < n; ++i) {
+                  total += static_cast<std::int64_t>(timestamps[i]);
+              }
+              return total;
+          },
+          [&] { return sum(std::views::all(timestamps)); });
+    }
+}
+
+TEST_CASE("accumulate", "[bench]")
+{
+    for (auto n : sizes()) {
+        // Sums wrap around.
+        std::vector<std::uint32_t> v(n);
+        std::iota(v.begin(), v.end(), 0);
+
+        bench_view(
+          "accumulate",
+          n,
+          [&] { return hash(v | views::accumulate()); },
+          [&] {
+              std::uint64_t h = 0;
+              std::uint32_t total = 0;
+              for (auto x : v) {
+                  total += x;
+                  h = h * 31 + static_cast<std::uint64_t>(total);
+              }
+              return h;
+          },
+          [&] {
+              // No lazy scan in std::ranges: std::inclusive_scan, into a vector.
+              std::vector<std::uint32_t> out(n);
+              std::inclusive_scan(v.begin(), v.end(), out.begin());
+              return hash(out);
+          });
+
+        // Materialized: SIMD, serial and over threads, against std::inclusive_scan.
+        BENCHMARK(fmt::format("scan/itertools/{}", n))
+        {
+            return (v | views::scan()).back();
+        };
+        BENCHMARK(fmt::format("scan/parallel/{}", n))
+        {
+            return (v | parallel::scan()).back();
+        };
+        BENCHMARK(fmt::format("scan/inclusive_scan/{}", n))
+        {
+            std::vector<std::uint32_t> out(n);
+            std::inclusive_scan(v.begin(), v.end(), out.begin());
+            return out.back();
+        };
+    }
+}
+
+TEST_CASE("tee", "[bench]")
+{
+    for (auto n : sizes()) {
+        auto v = make_vector(n);
+        // An upstream worth reading once.
+        auto parse = [](int x) { return static_cast<std::int64_t>(x) * x % 1'000'003; };
+
+        bench_view(
+          "tee",
+          n,
+          [&] {
+              // Two consumers, in lockstep.
+              auto [a, b] = views::tee<2>(v | views::transform(parse));
+              std::int64_t total = 0, max = 0;
+              auto it = b.begin();
+              for (auto x : a) {
+                  total += x;
+                  max = std::max(max, *it);
+                  ++it;
+              }
+              return total + max;
+          },
+          [&] {
+              std::int64_t total = 0, max = 0;
+              for (auto x : v) {
+                  auto y = parse(x);
+                  total += y;
+                  max = std::max(max, y);
+              }
+              return total + max;
+          },
+          [&] {
+              // Materialized, then read twice.
+              std::vector<std::int64_t> parsed(n);
+              std::ranges::transform(v, parsed.begin(), parse);
+              return sum(parsed) + std::ranges::max(parsed);
+          });
+    }
+}
+
+TEST_CASE("group_by", "[bench]")
+{
+    for (auto n : sizes()) {
+        // Sorted keys, in runs of 1 to 63.
+        std::vector<int> v;
+        v.reserve(n);
+        for (int key = 0; v.size() < n; ++key) {
+            for (int i = 0; i < key % 63 + 1 && v.size() < n; ++i) {
+                v.push_back(key);
+            }
+        }
+        auto same = [](int x) { return x; };
+
+        bench_view(
+          "group_by",
+          n,
+          [&] {
+              std::int64_t total = 0;
+              for (auto [key, group] : v | views::group_by()) {
+                  total += key * static_cast<std::int64_t>(group.size());
+              }
+              return total;
+          },
+          [&] {
+              std::int64_t total = 0;
+              for (std::size_t i = 0, j = 0; i < n; i = j) {
+                  for (j = i + 1; j < n && v[j] == v[i]; ++j) {
+                  }
+                  total += v[i] * static_cast<std::int64_t>(j - i);
+              }
+              return total;
+          },
+          [&] {
+              // By key function, as any other range.
+              std::int64_t total = 0;
+              for (auto [key, group] : v | views::group_by(same)) {
+                  total += key * static_cast<std::int64_t>(group.size());
+              }
+              return total;
+          });
+    }
+}
+
+TEST_CASE("permutations", "[bench]")
+{
+    for (std::size_t n : { 8, 10 }) {
+        auto v = make_vector(n);
+        // Every permutation's first and last elements, in order.
+        auto check = [](std::uint64_t h, auto&& p) {
+            return h * 31 + static_cast<std::uint64_t>(p[0] * 16 + p.back());
+        };
+
+        BENCHMARK(fmt::format("permutations/lexicographic/{}", n))
+        {
+            std::uint64_t h = 0;
+            for (auto p : views::permutations(v)) {
+                h = check(h, p);
+            }
+            return h;
+        };
+        BENCHMARK(fmt::format("permutations/minimal_change/{}", n))
+        {
+            std::uint64_t h = 0;
+            using views::permutation_order;
+            for (auto p : views::permutations<permutation_order::minimal_change>(v)) {
+                h = check(h, p);
+            }
+            return h;
+        };
+        BENCHMARK(fmt::format("permutations/next_permutation/{}", n))
+        {
+            std::uint64_t h = 0;
+            auto w = v;
+            do {
+                h = check(h, w);
+            } while (std::next_permutation(w.begin(), w.end()));
+            return h;
+        };
+    }
+}
+
+TEST_CASE("combinations", "[bench]")
+{
+    // Every triple of 200 features, and of 64 as bitmasks.
+    auto v = make_vector(200);
+    auto n = v.size();
+
+    BENCHMARK("combinations/itertools/200")
+    {
+        std::uint64_t h = 0;
+        for (auto c : views::combinations(v, 3)) {
+            h = h * 31 + static_cast<std::uint64_t>(c[0] * c[1] + c[2]);
+        }
+        return h;
+    };
+    BENCHMARK("combinations/loop/200")
+    {
+        std::uint64_t h = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = i + 1; j < n; ++j) {
+                for (std::size_t k = j + 1; k < n; ++k) {
+                    h = h * 31 + static_cast<std::uint64_t>(v[i] * v[j] + v[k]);
+                }
+            }
+        }
+        return h;
+    };
+    BENCHMARK("combinations/masks/64")
+    {
+        std::uint64_t h = 0;
+        for (auto mask : views::combination_masks(64, 3)) {
+            h = h * 31 + mask;
+        }
+        return h;
+    };
+    BENCHMARK("combinations/masks_loop/64")
+    {
+        std::uint64_t h = 0;
+        for (std::size_t i = 0; i < 64; ++i) {
+            for (std::size_t j = i + 1; j < 64; ++j) {
+                for (std::size_t k = j + 1; k < 64; ++k) {
+                    h = h * 31 + ((1ull << i) | (1ull << j) | (1ull << k));
+                }
+            }
+        }
+        return h;
+    };
+}
+
+int
+main(int argc, char* argv[])
+{
+    Catch::Session session;
+
+    auto cli = session.cli();
+    cli |= Catch::clara::Opt(max_elements, "n")["--max-elements"](
+      "skip the sizes above n elements (default 1e8)");
+    session.cli(cli);
+
+    if (auto ret = session.applyCommandLine(argc, argv)) {
+        return ret;
+    }
+    return session.run();
+}
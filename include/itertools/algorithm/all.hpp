@@ -1,6 +1,9 @@
 #include "begin_end.hpp"
 #include "equal.hpp"
 #include "find_if.hpp"
+#include "scan.hpp"
 #include "to.hpp"
+#include "to_fd.hpp"
+#include "to_snapshot.hpp"
 
 #pragma once
\ No newline at end of file
@@ -10,7 +10,7 @@ constexpr auto identity = []<class T>(T&& t) -> decltype(auto) {
 };
 
 template<tupletools::ForwardIterable I,
-         tupletools::ForwardIterable S,
+         class S,
          class Pred,
          class Proj = decltype(identity)>
 constexpr decltype(auto)
@@ -0,0 +1,88 @@
+#include "itertools/views/accumulate.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#pragma once
+
+namespace itertools {
+namespace parallel {
+
+// Ranges shorter than this many elements a thread are scanned on one.
+inline constexpr std::size_t scan_min_chunk = std::size_t(1) << 16;
+
+/*
+A sink: views::scan over threads, of a sized, random access range. Each thread
+scans a chunk of the range into place; the chunks' totals are scanned, in turn;
+then every chunk but the first has the total of those before it folded into each
+of its results. op must be associative, and is copied for each thread. "threads"
+defaults to the hardware's concurrency.
+ */
+template<class Op = std::plus<>>
+auto
+scan(Op&& op = {}, std::size_t threads = 0)
+{
+    return [op = std::forward<Op>(op), threads]<class Range>(Range&& range) mutable {
+        static_assert(std::ranges::random_access_range<Range> &&
+                        std::ranges::sized_range<Range>,
+                      "parallel::scan ranges must be sized and random access");
+        using T = std::ranges::range_value_t<Range>;
+
+        auto n = static_cast<std::size_t>(std::ranges::size(range));
+        std::size_t chunks = threads;
+        if (chunks == 0) {
+            chunks = std::max(1u, std::thread::hardware_concurrency());
+        }
+        chunks = std::min(chunks, n / scan_min_chunk);
+        if (chunks <= 1) {
+            return views::detail::scan<T, false>(op, std::nullopt, range);
+        }
+
+        std::vector<T> ret(n);
+        std::vector<T> totals(chunks);
+        auto first = std::ranges::begin(range);
+        auto bound = [&](std::size_t c) { return n * c / chunks; };
+
+        // Runs f(c) for each chunk, the first on this thread.
+        auto each_chunk = [&](auto f) {
+            std::vector<std::thread> pool;
+            for (std::size_t c = 1; c < chunks; ++c) {
+                pool.emplace_back(f, c);
+            }
+            f(0);
+            for (auto& thread : pool) {
+                thread.join();
+            }
+        };
+
+        each_chunk([&, op](std::size_t c) mutable {
+            auto lo = bound(c), hi = bound(c + 1);
+            ret[lo] = first[lo];
+            totals[c] = views::detail::scan_into(
+              first + lo + 1, hi - lo - 1, ret.data() + lo + 1, op, ret[lo]);
+        });
+
+        for (std::size_t c = 1; c < chunks; ++c) {
+            totals[c] = std::invoke(op, totals[c - 1], totals[c]);
+        }
+
+        each_chunk([&, op](std::size_t c) mutable {
+            if (c == 0) {
+                return;
+            }
+            const auto& offset = totals[c - 1];
+            for (auto i = bound(c), hi = bound(c + 1); i < hi; ++i) {
+                ret[i] = std::invoke(op, offset, ret[i]);
+            }
+        });
+        return ret;
+    };
+}
+
+}
+}
@@ -13,6 +13,26 @@ constexpr auto forward_inserter = [](auto& container, auto&& y) {
 
 constexpr auto copy_inserter = [](auto& container, auto y) { container.push_back(y); };
 
+namespace detail {
+/*
+Ranges that know how to fill a container better than one push_back at a time, as
+bounded repeats and cycles do; with the default inserter, to() leaves it to them.
+ */
+template<class Range, class Container>
+concept BulkAssignable = requires(Range& range, Container& container)
+{
+    range.assign_to(container);
+};
+
+template<class Func, class Inserter>
+concept SameInserter =
+  std::same_as<std::remove_cvref_t<Func>, std::remove_cvref_t<Inserter>>;
+
+template<class Func>
+concept DefaultInserter = SameInserter<Func, decltype(copy_inserter)> ||
+                          SameInserter<Func, decltype(forward_inserter)>;
+}
+
 template<template<typename... Ts> class Container, class Func = decltype(copy_inserter)>
 decltype(auto)
 to(Func&& inserter = {})
@@ -22,9 +42,14 @@ to(Func&& inserter = {})
         using Value = std::remove_cvref_t<tupletools::range_value_t<Range>>;
         auto container = Container<Value>{};
 
-        for (auto&& x : range) {
-            using T = decltype(x);
-            inserter(container, std::forward<T>(x));
+        if constexpr (detail::DefaultInserter<Func> &&
+                      detail::BulkAssignable<Range, Container<Value>>) {
+            range.assign_to(container);
+        } else {
+            for (auto&& x : range) {
+                using T = decltype(x);
+                inserter(container, std::forward<T>(x));
+            }
         }
 
         return container;
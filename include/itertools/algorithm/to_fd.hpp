@@ -0,0 +1,266 @@
+#include "fmt/format.h"
+
+#include "itertools/range_iterator.hpp"
+#include "itertools/views/split.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <iterator>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#pragma once
+
+namespace itertools {
+namespace detail {
+
+/*
+Batches writes to a file descriptor. Small pieces, and formatted values, are copied
+into a buffer; pieces at least "gather_size" long, whose storage outlives the
+writer, are instead referenced as is. Both are written out together with writev
+once the buffer fills, or the gather list does.
+
+Values are formatted into the buffer's spare capacity, never growing it: one that
+doesn't fit is formatted again into the emptied buffer after a flush, and one longer
+than the whole buffer into storage of its own, the only time formatting allocates.
+ */
+class fd_writer
+{
+  public:
+    static constexpr std::size_t gather_size = 1024;
+
+    // Room past "buffer_size" for the value formatted last: most fit without a flush.
+    static constexpr std::size_t format_slack = 256;
+
+    fd_writer(int fd, std::size_t buffer_size)
+      : fd(fd)
+      , buffer_size(buffer_size)
+    {
+        buffer.reserve(buffer_size + format_slack);
+    }
+
+    fd_writer(const fd_writer&) = delete;
+    fd_writer& operator=(const fd_writer&) = delete;
+
+    void copy(std::string_view bytes)
+    {
+        if (buffer.size() + bytes.size() > buffer_size) {
+            flush();
+        }
+        if (bytes.size() >= buffer_size) {
+            gather(bytes);
+            flush();
+        } else {
+            buffer.append(bytes.data(), bytes.data() + bytes.size());
+        }
+    }
+
+    // Only for bytes that stay put until the next flush().
+    void write(std::string_view bytes)
+    {
+        if (bytes.size() >= gather_size) {
+            gather(bytes);
+        } else {
+            copy(bytes);
+        }
+    }
+
+    template<class T>
+    void format(const T& x)
+    {
+        if (buffer.size() + format_slack > buffer_size) {
+            flush();
+        }
+        // A number's never longer than the slack: format it straight in.
+        if constexpr (std::is_arithmetic_v<T>) {
+            fmt::format_to(std::back_inserter(buffer), "{}", x);
+        } else if (!format_into_room(x)) {
+            flush();
+            if (!format_into_room(x)) {
+                fmt::memory_buffer value;
+                fmt::format_to(std::back_inserter(value), "{}", x);
+                copy({ value.data(), value.size() });
+            }
+        }
+    }
+
+    void flush()
+    {
+        end_segment();
+
+        std::array<iovec, max_segments> iovs;
+        for (std::size_t i = 0; i < n_segments; ++i) {
+            auto [data, size] = segments[i];
+            // Resolved only now, as the buffer may have moved since.
+            auto* base = data ? data : buffer.data() + buffered_offsets[i];
+            iovs[i] = { const_cast<char*>(base), size };
+        }
+
+        auto* iov = iovs.data();
+        auto count = n_segments;
+        while (count > 0) {
+            auto n = ::writev(fd, iov, static_cast<int>(count));
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "to_fd");
+            }
+            written += static_cast<std::size_t>(n);
+
+            // Skip past what was written, which may end partway into a segment.
+            auto m = static_cast<std::size_t>(n);
+            for (; count > 0 && m >= iov->iov_len; ++iov, --count) {
+                m -= iov->iov_len;
+            }
+            if (count > 0) {
+                iov->iov_base = static_cast<char*>(iov->iov_base) + m;
+                iov->iov_len -= m;
+            }
+        }
+
+        n_segments = 0;
+        buffered = 0;
+        buffer.clear();
+    }
+
+    // Bytes written so far; flush() before reading it.
+    std::size_t written = 0;
+
+  private:
+    static constexpr std::size_t max_segments = 64;
+
+    // The buffer's contents since the last segment, as a segment.
+    void end_segment()
+    {
+        if (buffer.size() > buffered) {
+            buffered_offsets[n_segments] = buffered;
+            segments[n_segments++] = { nullptr, buffer.size() - buffered };
+            buffered = buffer.size();
+        }
+    }
+
+    // Formats x into the buffer's spare capacity, if it fits there.
+    template<class T>
+    bool format_into_room(const T& x)
+    {
+        auto size = buffer.size();
+        auto room = buffer.capacity() - size;
+        buffer.resize(buffer.capacity());
+        auto result = fmt::format_to_n(buffer.data() + size, room, "{}", x);
+        bool fits = result.size <= room;
+        buffer.resize(fits ? size + result.size : size);
+        return fits;
+    }
+
+    void gather(std::string_view bytes)
+    {
+        end_segment();
+        if (n_segments + 1 >= max_segments) {
+            flush();
+        }
+        segments[n_segments++] = { bytes.data(), bytes.size() };
+    }
+
+    int fd;
+    std::size_t buffer_size;
+
+    fmt::memory_buffer buffer;
+    std::size_t buffered = 0;
+
+    // Pending writes: bytes held elsewhere, or (with null data) spans of the buffer.
+    std::array<std::pair<const char*, std::size_t>, max_segments> segments;
+    std::array<std::size_t, max_segments> buffered_offsets;
+    std::size_t n_segments = 0;
+};
+
+template<class Range>
+constexpr auto
+as_bytes(Range&& range)
+{
+    return std::string_view(reinterpret_cast<const char*>(std::ranges::data(range)),
+                            std::ranges::size(range));
+}
+
+template<class Range>
+std::size_t
+write_to_fd(Range&& range, int fd, std::string_view sep, std::size_t buffer_size)
+{
+    using reference = std::ranges::range_reference_t<Range>;
+
+    fd_writer writer(fd, buffer_size);
+
+    if constexpr (views::detail::ByteRange<Range>) {
+        writer.write(as_bytes(range));
+    } else {
+        // Elements that outlive the next increment can be gathered by reference.
+        constexpr bool stable = std::ranges::forward_range<Range> &&
+                                std::ranges::borrowed_range<reference>;
+
+        for (auto&& x : range) {
+            if constexpr (views::detail::ByteRange<reference> && stable) {
+                writer.write(as_bytes(x));
+            } else if constexpr (views::detail::ByteRange<reference>) {
+                writer.copy(as_bytes(x));
+            } else {
+                writer.format(x);
+            }
+            writer.copy(sep);
+        }
+    }
+
+    writer.flush();
+    return writer.written;
+}
+
+}
+
+/*
+Writes a range to a file descriptor, returning the number of bytes written. A
+contiguous range of bytes is written as is, without copying. Otherwise, each element
+is written followed by "sep": ranges of bytes (strings, string_views, lines) as
+they are, and anything else as formatted by fmt. Output is batched into blocks of
+about "buffer_size" bytes, gathered with writev.
+
+The descriptor isn't closed; failed writes throw std::system_error.
+ */
+inline auto
+to_fd(int fd, std::string_view sep = "\n", std::size_t buffer_size = 1 << 16)
+{
+    return [=]<class Range>(Range&& range) {
+        return detail::write_to_fd(std::forward<Range>(range), fd, sep, buffer_size);
+    };
+}
+
+// As to_fd, to a file at "path", created or truncated.
+inline auto
+to_file(std::filesystem::path path, std::string_view sep = "\n",
+        std::size_t buffer_size = 1 << 16)
+{
+    return [=, path = std::move(path)]<class Range>(Range&& range) {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), path.string());
+        }
+
+        try {
+            auto n =
+              detail::write_to_fd(std::forward<Range>(range), fd, sep, buffer_size);
+            ::close(fd);
+            return n;
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+    };
+}
+
+}
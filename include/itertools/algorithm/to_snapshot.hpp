@@ -0,0 +1,229 @@
+#include "itertools/types.hpp"
+#include "itertools/views/snapshot.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#pragma once
+
+namespace itertools {
+namespace detail {
+
+/*
+The columns a range's elements are split into: each of a tuple's (a zip's, say)
+elements, or otherwise the element itself.
+ */
+template<class Value>
+struct snapshot_columns
+{
+    using type = std::tuple<Value>;
+
+    template<std::size_t I, class T>
+    static decltype(auto) get(T&& x)
+    {
+        return std::forward<T>(x);
+    }
+};
+
+template<Tupleoid Value>
+struct snapshot_columns<Value>
+{
+    using type = decltype([]<std::size_t... Is>(std::index_sequence<Is...>) {
+        return std::tuple<std::remove_cvref_t<std::tuple_element_t<Is, Value>>...>{};
+    }(std::make_index_sequence<std::tuple_size_v<Value>>{}));
+
+    template<std::size_t I, class T>
+    static decltype(auto) get(T&& x)
+    {
+        return std::get<I>(std::forward<T>(x));
+    }
+};
+
+template<class... T>
+constexpr auto
+snapshot_layout_of(std::tuple<T...>*, std::uint64_t rows)
+{
+    return views::detail::snapshot_layout<T...>(rows);
+}
+
+// Writes all of "bytes" at "offset", however many pwrites that takes.
+inline void
+pwrite_all(int fd, std::string_view bytes, std::uint64_t offset)
+{
+    while (!bytes.empty()) {
+        auto n = ::pwrite(fd, bytes.data(), bytes.size(), static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "to_snapshot");
+        }
+        bytes.remove_prefix(static_cast<std::size_t>(n));
+        offset += static_cast<std::uint64_t>(n);
+    }
+}
+
+// One column's values, batched and written at the column's place in the file.
+class snapshot_column_writer
+{
+  public:
+    static constexpr std::size_t buffer_size = 1 << 16;
+
+    snapshot_column_writer(int fd, std::uint64_t offset)
+      : fd(fd)
+      , offset(offset)
+    {
+        buffer.reserve(buffer_size);
+    }
+
+    void copy(std::string_view bytes)
+    {
+        if (buffer.size() + bytes.size() > buffer_size) {
+            flush();
+        }
+        buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+    }
+
+    void flush()
+    {
+        pwrite_all(fd, { buffer.data(), buffer.size() }, offset);
+        offset += buffer.size();
+        buffer.clear();
+    }
+
+  private:
+    int fd;
+    std::uint64_t offset;
+    std::vector<char> buffer;
+};
+
+/*
+Writes a range to a snapshot in one pass over it, as a pipeline's elements may be
+expensive to compute: every column's written at once, each at its own offset, which
+needs the number of rows first. A range that isn't sized is read into a vector, to
+count them.
+ */
+template<class Range>
+std::uint64_t
+write_snapshot(Range&& range, int fd)
+{
+    using value = std::remove_cvref_t<std::ranges::range_reference_t<Range>>;
+    using columns_t = snapshot_columns<value>;
+    using types = typename columns_t::type;
+    constexpr auto n_columns = std::tuple_size_v<types>;
+    static_assert(
+      []<class... T>(std::tuple<T...>*) {
+          return (std::is_trivially_copyable_v<T> && ...);
+      }(static_cast<types*>(nullptr)),
+      "snapshot columns must be trivially copyable");
+
+    if constexpr (!std::ranges::sized_range<Range>) {
+        using stored = std::conditional_t<Tupleoid<value>, types, value>;
+        std::vector<stored> values;
+        for (auto&& x : range) {
+            values.emplace_back(std::forward<decltype(x)>(x));
+        }
+        return write_snapshot(values, fd);
+    } else {
+        auto rows = static_cast<std::uint64_t>(std::ranges::size(range));
+        auto layout = snapshot_layout_of(static_cast<types*>(nullptr), rows);
+
+        pwrite_all(fd,
+                   { reinterpret_cast<const char*>(&layout.header),
+                     sizeof layout.header },
+                   0);
+        pwrite_all(fd,
+                   { reinterpret_cast<const char*>(layout.columns.data()),
+                     sizeof layout.columns },
+                   sizeof layout.header);
+
+        // A contiguous column is written from where it lies.
+        if constexpr (n_columns == 1 && std::ranges::contiguous_range<Range>) {
+            pwrite_all(fd,
+                       { reinterpret_cast<const char*>(std::ranges::data(range)),
+                         rows * sizeof(std::tuple_element_t<0, types>) },
+                       layout.columns[0].offset);
+        } else {
+            [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                std::array writers{ snapshot_column_writer(
+                  fd, layout.columns[Is].offset)... };
+                for (auto&& x : range) {
+                    (
+                      [&] {
+                          using T = std::tuple_element_t<Is, types>;
+                          const T& y = columns_t::template get<Is>(x);
+                          writers[Is].copy(
+                            { reinterpret_cast<const char*>(&y), sizeof(T) });
+                      }(),
+                      ...);
+                }
+                for (auto& writer : writers) {
+                    writer.flush();
+                }
+            }(std::make_index_sequence<n_columns>{});
+        }
+
+        // The gaps between columns are holes, read as zeros; the last ends the file.
+        const auto& last = layout.columns[n_columns - 1];
+        if (::ftruncate(fd, static_cast<off_t>(last.offset + rows * last.size)) < 0) {
+            throw std::system_error(errno, std::generic_category(), "to_snapshot");
+        }
+        return rows;
+    }
+}
+
+}
+
+/*
+Writes a range of trivially copyable values to a snapshot file at "path", which
+views::from_snapshot maps back, without copying or parsing. A range of tuples (a
+zip, for one) is stored a column per element. The file is written beside "path"
+and renamed over it, so that a reader never sees it half-written. The range is read
+once, however many columns it has. Returns the number of rows.
+
+    views::zip(ids, scores) | to_snapshot("scores.snap");
+ */
+inline auto
+to_snapshot(std::filesystem::path path)
+{
+    return [path = std::move(path)]<class Range>(Range&& range) {
+        auto tmp = path;
+        tmp += ".tmp";
+
+        int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), tmp.string());
+        }
+
+        try {
+            auto rows = detail::write_snapshot(std::forward<Range>(range), fd);
+            auto closed = ::close(fd);
+            fd = -1;
+            if (closed < 0) {
+                throw std::system_error(errno, std::generic_category(), tmp.string());
+            }
+            std::filesystem::rename(tmp, path);
+            return rows;
+        } catch (...) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            std::filesystem::remove(tmp);
+            throw;
+        }
+    };
+}
+
+}
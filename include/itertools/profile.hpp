@@ -0,0 +1,344 @@
+#ifndef ITERTOOLS_PROFILE_H
+#define ITERTOOLS_PROFILE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#pragma once
+
+/*
+Pipeline profiling. Each probed stage of a pipeline (see views::probe) owns a "stage"
+here, in which it records the elements it yields, an estimate of the time spent
+producing them, and the allocations made while doing so.
+
+Time is sampled: one in every ITERTOOLS_PROFILE_SAMPLE_PERIOD increments and
+dereferences is timed, and the total scaled up accordingly. Times are inclusive of
+every stage upstream; "self" subtracts the upstream stage's time.
+
+Allocations are only counted in programs that expand ITERTOOLS_COUNT_ALLOCATIONS()
+in one of their translation units.
+ */
+
+#ifndef ITERTOOLS_PROFILE_SAMPLE_PERIOD
+#define ITERTOOLS_PROFILE_SAMPLE_PERIOD 64
+#endif
+
+namespace itertools {
+namespace profile {
+
+using clock = std::chrono::steady_clock;
+
+constexpr std::uint64_t sample_period = ITERTOOLS_PROFILE_SAMPLE_PERIOD;
+
+// Bumped by the operator new and delete installed with ITERTOOLS_COUNT_ALLOCATIONS().
+inline thread_local std::uint64_t allocations = 0;
+inline thread_local std::uint64_t deallocations = 0;
+
+/*
+Counts the allocations and deallocations made on this thread during its lifetime.
+
+    profile::allocation_scope scope;
+    for (auto&& x : pipeline) { ... }
+    assert(scope.allocations() == 0);
+ */
+class allocation_scope
+{
+  public:
+    std::uint64_t allocations() const { return profile::allocations - start; }
+    std::uint64_t deallocations() const
+    {
+        return profile::deallocations - start_deallocations;
+    }
+
+  private:
+    std::uint64_t start = profile::allocations;
+    std::uint64_t start_deallocations = profile::deallocations;
+};
+
+// The least time two back to back reads of the clock are apart; taken off each sample.
+inline clock::duration
+clock_overhead()
+{
+    static const auto overhead = [] {
+        auto least = clock::duration::max();
+        for (int i = 0; i < 1000; ++i) {
+            auto t = clock::now();
+            least = std::min(least, clock::now() - t);
+        }
+        return least;
+    }();
+    return overhead;
+}
+
+class stage
+{
+  public:
+    std::string name;
+    // The nearest probed stage this stage draws its elements from, if any.
+    const stage* upstream = nullptr;
+
+    std::atomic<std::uint64_t> elements = 0;
+    std::atomic<std::uint64_t> derefs = 0;
+    std::atomic<std::uint64_t> ns = 0;
+    std::atomic<std::uint64_t> allocs = 0;
+
+    stage(std::string name, const stage* upstream)
+      : name(std::move(name))
+      , upstream(upstream)
+    {}
+
+    void reset()
+    {
+        elements = 0;
+        derefs = 0;
+        ns = 0;
+        allocs = 0;
+    }
+
+    // Runs "f", timing it if "n", the count of like operations, falls on a sample.
+    template<class F>
+    decltype(auto) record(std::uint64_t n, F&& f)
+    {
+        auto a = allocations;
+        struct guard
+        {
+            stage& s;
+            std::uint64_t a;
+            std::uint64_t n;
+            clock::time_point t;
+
+            ~guard()
+            {
+                if (n % sample_period == 0) {
+                    auto dt = std::max(clock::now() - t - clock_overhead(),
+                                       clock::duration::zero());
+                    auto ns =
+                      std::chrono::duration_cast<std::chrono::nanoseconds>(dt).count();
+                    s.ns.fetch_add(ns * sample_period, std::memory_order_relaxed);
+                }
+                if (allocations != a) {
+                    s.allocs.fetch_add(allocations - a, std::memory_order_relaxed);
+                }
+            }
+        } g{ *this, a, n, n % sample_period == 0 ? clock::now() : clock::time_point{} };
+
+        return std::forward<F>(f)();
+    }
+
+    // Times "f" unconditionally; for one-off work such as computing a begin().
+    template<class F>
+    decltype(auto) record_once(F&& f)
+    {
+        return record(0, std::forward<F>(f));
+    }
+
+    std::uint64_t elements_in() const
+    {
+        return upstream ? upstream->elements.load() : 0;
+    }
+
+    std::uint64_t self_ns() const
+    {
+        auto upstream_ns = upstream ? upstream->ns.load() : 0;
+        return ns > upstream_ns ? ns - upstream_ns : 0;
+    }
+};
+
+namespace detail {
+
+struct registry
+{
+    std::mutex mutex;
+    // A deque, so that stages never move once handed out.
+    std::deque<stage> stages;
+};
+
+inline registry&
+get_registry()
+{
+    static registry r;
+    return r;
+}
+
+inline std::string
+json_escape(std::string_view s)
+{
+    std::string ret;
+    for (auto c : s) {
+        if (c == '"' || c == '\\') {
+            ret += '\\';
+        }
+        ret += c;
+    }
+    return ret;
+}
+
+}
+
+/*
+The stage named "name", created on first use. Stages are shared by name, so a
+pipeline built repeatedly accumulates into the same stages.
+ */
+inline stage&
+get_stage(std::string_view name, const stage* upstream = nullptr)
+{
+    auto& r = detail::get_registry();
+    std::scoped_lock lock(r.mutex);
+
+    // Calibrated now, rather than inside the first sample.
+    clock_overhead();
+
+    for (auto& s : r.stages) {
+        if (s.name == name) {
+            if (!s.upstream) {
+                s.upstream = upstream;
+            }
+            return s;
+        }
+    }
+    return r.stages.emplace_back(std::string(name), upstream);
+}
+
+// Zeroes every stage's counters; stages themselves are kept, as probes refer to them.
+inline void
+reset()
+{
+    auto& r = detail::get_registry();
+    std::scoped_lock lock(r.mutex);
+
+    for (auto& s : r.stages) {
+        s.reset();
+    }
+}
+
+/*
+A table of every stage: elements in and out, selectivity (out / in), estimated
+time in total, self, and per element out, and allocations.
+ */
+inline std::string
+report()
+{
+    auto& r = detail::get_registry();
+    std::scoped_lock lock(r.mutex);
+
+    std::size_t width = 5;
+    for (auto& s : r.stages) {
+        width = std::max(width, s.name.size());
+    }
+
+    std::ostringstream os;
+    os << std::left << std::setw(width) << "stage" << std::right << std::setw(14)
+       << "in" << std::setw(14) << "out" << std::setw(12) << "selectivity"
+       << std::setw(14) << "ns" << std::setw(14) << "self ns" << std::setw(10)
+       << "ns/elem" << std::setw(10) << "allocs" << '\n';
+
+    for (auto& s : r.stages) {
+        auto in = s.elements_in();
+        auto out = s.elements.load();
+
+        os << std::left << std::setw(width) << s.name << std::right << std::setw(14);
+        if (s.upstream) {
+            os << in;
+        } else {
+            os << "-";
+        }
+        os << std::setw(14) << out << std::setw(12) << std::fixed
+           << std::setprecision(4);
+        if (in) {
+            os << static_cast<double>(out) / in;
+        } else {
+            os << "-";
+        }
+        os << std::setw(14) << s.ns.load() << std::setw(14) << s.self_ns()
+           << std::setw(10) << std::setprecision(2)
+           << (out ? static_cast<double>(s.ns) / out : 0.0) << std::setw(10)
+           << s.allocs.load() << '\n';
+    }
+    return os.str();
+}
+
+// The same as report, as a JSON array of one object per stage.
+inline std::string
+report_json()
+{
+    auto& r = detail::get_registry();
+    std::scoped_lock lock(r.mutex);
+
+    std::ostringstream os;
+    os << "[";
+    for (std::size_t i = 0; i < r.stages.size(); ++i) {
+        auto& s = r.stages[i];
+        auto in = s.elements_in();
+        auto out = s.elements.load();
+
+        os << (i ? ",\n " : "\n ") << "{ \"stage\": \"" << detail::json_escape(s.name)
+           << "\", \"upstream\": ";
+        if (s.upstream) {
+            os << '"' << detail::json_escape(s.upstream->name) << '"';
+        } else {
+            os << "null";
+        }
+        os << ", \"in\": " << in << ", \"out\": " << out << ", \"selectivity\": ";
+        if (in) {
+            os << static_cast<double>(out) / in;
+        } else {
+            os << "null";
+        }
+        os << ", \"ns\": " << s.ns.load() << ", \"self_ns\": " << s.self_ns()
+           << ", \"allocations\": " << s.allocs.load() << " }";
+    }
+    os << "\n]\n";
+    return os.str();
+}
+
+}
+}
+
+/*
+Replaces the global operator new and delete, aligned or not, with ones that count
+into profile::allocations and profile::deallocations; the array and nothrow forms
+forward to these. Expand it at namespace scope in exactly one translation unit.
+ */
+#define ITERTOOLS_COUNT_ALLOCATIONS()                                                  \
+    void* operator new(std::size_t n)                                                  \
+    {                                                                                  \
+        ++itertools::profile::allocations;                                             \
+        if (void* p = std::malloc(n ? n : 1)) {                                        \
+            return p;                                                                  \
+        }                                                                              \
+        throw std::bad_alloc{};                                                        \
+    }                                                                                  \
+    void* operator new(std::size_t n, std::align_val_t align)                          \
+    {                                                                                  \
+        ++itertools::profile::allocations;                                             \
+        auto a = static_cast<std::size_t>(align);                                      \
+        if (void* p = std::aligned_alloc(a, (n + a - 1) / a * a)) {                    \
+            return p;                                                                  \
+        }                                                                              \
+        throw std::bad_alloc{};                                                        \
+    }                                                                                  \
+    void operator delete(void* p) noexcept                                             \
+    {                                                                                  \
+        if (p) {                                                                       \
+            ++itertools::profile::deallocations;                                       \
+            std::free(p);                                                              \
+        }                                                                              \
+    }                                                                                  \
+    void operator delete(void* p, std::size_t) noexcept { operator delete(p); }        \
+    void operator delete(void* p, std::align_val_t) noexcept { operator delete(p); }   \
+    void operator delete(void* p, std::size_t, std::align_val_t) noexcept              \
+    {                                                                                  \
+        operator delete(p);                                                            \
+    }
+
+#endif // ITERTOOLS_PROFILE_H
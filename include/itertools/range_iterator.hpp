@@ -4,13 +4,21 @@
 #include "tupletools.hpp"
 #include "types.hpp"
 
+#include <compare>
+#include <iterator>
 #include <numeric>
+#include <optional>
+#include <ranges>
 #include <string>
 
 #include <type_traits>
 
 #pragma once
 
+#if defined(ITERTOOLS_PROFILE_ALL) && !defined(ITERTOOLS_PROFILE)
+#define ITERTOOLS_PROFILE
+#endif
+
 namespace itertools {
 using namespace tupletools;
 
@@ -23,75 +31,332 @@ using iter_begin_t = decltype(std::declval<R>().begin());
 template<Rangeable R>
 using iter_end_t = decltype(std::declval<R>().end());
 
+/*
+The strongest std:: iterator concept tag that an adapted iterator can advertise.
+Contiguity is never propagated: an adaptor's operator* is free to produce something
+other than an lvalue into the underlying storage.
+ */
+template<class Iter>
+using iterator_concept_t = std::conditional_t<
+  std::random_access_iterator<Iter>,
+  std::random_access_iterator_tag,
+  std::conditional_t<
+    std::bidirectional_iterator<Iter>,
+    std::bidirectional_iterator_tag,
+    std::conditional_t<std::forward_iterator<Iter>,
+                       std::forward_iterator_tag,
+                       std::input_iterator_tag>>>;
+
+namespace detail {
+
 template<class Iter>
-class range_iterator
+struct range_iterator_traits
+{
+    using difference_type = std::ptrdiff_t;
+};
+
+template<std::input_iterator Iter>
+struct range_iterator_traits<Iter>
+{
+    using difference_type = std::iter_difference_t<Iter>;
+    using value_type = std::iter_value_t<Iter>;
+    using iterator_concept = iterator_concept_t<Iter>;
+};
+
+}
+
+/*
+Base of every view's iterator. Holds the underlying iterator, "it", and supplies the
+boilerplate std::ranges asks of an iterator: default construction, postfix
+increments, and, for iterators advertising random access, the arithmetic and
+ordering operators.
+
+Derived iterators pass themselves as "Derived" so that the generated operators
+dispatch to their own prefix ++/--, +=, and operator*. With "Derived" left void, a
+range_iterator is a plain pass-through wrapper.
+ */
+template<class Iter, class Derived = void>
+class range_iterator : public detail::range_iterator_traits<Iter>
 {
   public:
-    using iterator_type = std::remove_cvref_t<Iter>;
+    using iterator_type = Iter;
+    using self_t = std::conditional_t<std::is_void_v<Derived>, range_iterator, Derived>;
+    using difference_type = typename detail::range_iterator_traits<Iter>::difference_type;
 
     Iter it;
 
-    constexpr range_iterator(Iter&& it)
-      : it{ std::forward<Iter>(it) }
+    /*
+    Whether the derived iterator advertises random access; the arithmetic operators
+    below are only offered to those that do.
+     */
+    static constexpr bool is_random_access = requires
+    {
+        requires std::derived_from<typename self_t::iterator_concept,
+                                   std::random_access_iterator_tag>;
+    };
+
+    constexpr range_iterator() = default;
+
+    constexpr range_iterator(Iter it)
+      : it{ std::move(it) }
     {}
 
-    range_iterator(const range_iterator& other) = default;
-    range_iterator& operator=(const range_iterator& other)
+    constexpr bool operator==(const range_iterator& rhs) const { return it == rhs.it; }
+
+    constexpr std::weak_ordering operator<=>(const range_iterator& rhs) const
+      requires is_random_access
     {
-        it = other.it;
-        return *this;
+        if (it < rhs.it) {
+            return std::weak_ordering::less;
+        } else if (rhs.it < it) {
+            return std::weak_ordering::greater;
+        }
+        return std::weak_ordering::equivalent;
     }
-    ~range_iterator() = default;
-
-    bool operator==(const range_iterator<Iter>& rhs) const { return it == rhs.it; }
 
-    decltype(auto) operator++()
+    constexpr self_t& operator++()
     {
         ++it;
-        return *this;
+        return self();
     }
 
-    decltype(auto) operator--()
+    constexpr self_t& operator--()
     {
         --it;
-        return *this;
+        return self();
     }
 
-    decltype(auto) operator*() { return *it; }
+    constexpr self_t operator++(int)
+    {
+        auto tmp = self();
+        ++self();
+        return tmp;
+    }
+
+    constexpr self_t operator--(int)
+    {
+        auto tmp = self();
+        --self();
+        return tmp;
+    }
+
+    constexpr decltype(auto) operator*() const { return *it; }
+
+    constexpr decltype(auto) operator->() const { return it; }
 
-    decltype(auto) operator->() { return it; }
+    constexpr self_t& operator+=(difference_type n)
+      requires is_random_access
+    {
+        it += n;
+        return self();
+    }
+
+    constexpr self_t& operator-=(difference_type n)
+      requires is_random_access
+    {
+        self() += -n;
+        return self();
+    }
+
+    constexpr decltype(auto) operator[](difference_type n) const
+      requires is_random_access
+    {
+        return *(self() + n);
+    }
+
+    constexpr self_t operator+(difference_type n) const
+      requires is_random_access
+    {
+        auto tmp = self();
+        tmp += n;
+        return tmp;
+    }
+
+    constexpr self_t operator-(difference_type n) const
+      requires is_random_access
+    {
+        auto tmp = self();
+        tmp -= n;
+        return tmp;
+    }
+
+    friend constexpr self_t operator+(difference_type n, const self_t& rhs)
+      requires is_random_access
+    {
+        return rhs + n;
+    }
+
+    // Only the distance of a random access iterator is its underlying iterator's.
+    constexpr difference_type operator-(const range_iterator& rhs) const
+      requires is_random_access && std::sized_sentinel_for<Iter, Iter>
+    {
+        return it - rhs.it;
+    }
+
+    friend constexpr decltype(auto) iter_move(const range_iterator& i) noexcept(
+      noexcept(std::ranges::iter_move(i.it))) requires std::is_void_v<Derived>
+    {
+        return std::ranges::iter_move(i.it);
+    }
+
+  protected:
+    constexpr self_t& self() { return static_cast<self_t&>(*this); }
+    constexpr const self_t& self() const { return static_cast<const self_t&>(*this); }
 };
 
 template<class Iter>
-range_iterator(Iter&&) -> range_iterator<Iter>;
+range_iterator(Iter&&) -> range_iterator<std::remove_cvref_t<Iter>>;
 
-template<class Range, class Begin = iter_begin_t<Range>, class End = iter_end_t<Range>>
+/*
+An end-of-range marker wrapping the underlying range's sentinel; used as a view's
+end() when the underlying range is not a common range. Any iterator deriving from
+range_iterator compares equal to it once its underlying iterator reaches "end".
+ */
+template<class Sent>
+class range_sentinel
+{
+  public:
+    Sent end;
+
+    constexpr range_sentinel() = default;
+
+    constexpr explicit range_sentinel(Sent end)
+      : end{ std::move(end) }
+    {}
+
+    template<class Iter, class Derived>
+    friend constexpr bool operator==(const range_iterator<Iter, Derived>& lhs,
+                                     const range_sentinel& rhs)
+    {
+        return lhs.it == rhs.end;
+    }
+};
+
+/*
+Makes a copy-constructible callable (a lambda, typically) assignable, so that views
+holding one still model std::movable.
+ */
+template<class T>
+class movable_box : public std::optional<T>
+{
+  public:
+    using std::optional<T>::optional;
+
+    constexpr movable_box() noexcept(std::is_nothrow_default_constructible_v<T>)
+      requires std::default_initializable<T>
+      : std::optional<T>{ std::in_place }
+    {}
+
+    movable_box(const movable_box&) = default;
+    movable_box(movable_box&&) = default;
+
+    constexpr movable_box& operator=(const movable_box& other)
+    {
+        if (this != std::addressof(other)) {
+            if (other) {
+                this->emplace(*other);
+            } else {
+                this->reset();
+            }
+        }
+        return *this;
+    }
+
+    constexpr movable_box& operator=(movable_box&& other) noexcept(
+      std::is_nothrow_move_constructible_v<T>)
+    {
+        if (this != std::addressof(other)) {
+            if (other) {
+                this->emplace(std::move(*other));
+            } else {
+                this->reset();
+            }
+        }
+        return *this;
+    }
+};
+
+/*
+Views never hold a bare reference: lvalue ranges are held through a
+std::ranges::ref_view, rvalue ranges are moved into a std::ranges::owning_view, and
+views are stored by value.
+ */
+template<class Range>
+using view_t = std::views::all_t<Range>;
+
+template<class Range>
+constexpr view_t<Range>
+to_view(Range&& range)
+{
+    return std::views::all(std::forward<Range>(range));
+}
+
+template<class Range>
+using view_iterator_t = std::ranges::iterator_t<view_t<Range>>;
+
+template<class Range>
+using view_sentinel_t = std::ranges::sentinel_t<view_t<Range>>;
+
+/*
+A view whose begin and end are computed once, on first use, and then reused.
+Copying or moving the view drops the cache, as the cached iterators may refer into
+the storage of the view that was copied from.
+ */
+template<class Range,
+         class Begin = view_iterator_t<Range>,
+         class End = view_sentinel_t<Range>>
 class cached_container
 {
   public:
     using begin_t = std::remove_cvref_t<Begin>;
     using end_t = std::remove_cvref_t<End>;
 
-    Range range;
+    view_t<Range> range;
     std::optional<begin_t> begin_;
     std::optional<end_t> end_;
-    bool was_cached = false;
 
     cached_container(Range&& range)
-      : range{ std::forward<Range>(range) }
+      : range{ to_view(std::forward<Range>(range)) }
+    {}
+
+    cached_container(const cached_container& other)
+      : range{ other.range }
+    {}
+
+    cached_container(cached_container&& other)
+      : range{ std::move(other.range) }
     {}
 
+    cached_container& operator=(const cached_container& other)
+    {
+        range = other.range;
+        reset();
+        return *this;
+    }
+
+    cached_container& operator=(cached_container&& other)
+    {
+        range = std::move(other.range);
+        reset();
+        return *this;
+    }
+
+    virtual ~cached_container() = default;
+
     virtual void init_begin() = 0;
     virtual void init_end() = 0;
 
+    void reset()
+    {
+        begin_.reset();
+        end_.reset();
+    }
+
     void cache()
     {
-        if (was_cached || !(begin_ || end_)) {
+        if (!(begin_ && end_)) {
             init_begin();
             init_end();
-            was_cached = false;
-        } else {
-            was_cached = true;
         }
     }
 
@@ -108,27 +373,62 @@ class cached_container
     }
 };
 
+#ifdef ITERTOOLS_PROFILE_ALL
+namespace profile {
+class stage;
+}
+
+namespace views::detail {
+template<class Range>
+constexpr decltype(auto)
+probe_source(Range&& range);
+
+template<class Range>
+constexpr decltype(auto)
+probe_result(Range&& range, const profile::stage* source);
+
 template<class Range>
-cached_container(Range&&) -> cached_container<Range>;
+constexpr profile::stage*
+find_stage(Range& range);
+}
+#endif
 
+/*
+Under ITERTOOLS_PROFILE_ALL, every stage applied through here is probed; see
+views/probe.hpp.
+ */
 template<ForwardRange Range, class Func>
-requires invocable<Func, Range> constexpr auto
+requires invocable<Func, Range> constexpr decltype(auto)
 operator|(Range&& rhs, Func&& lhs)
 {
+#ifdef ITERTOOLS_PROFILE_ALL
+    auto&& source = views::detail::probe_source(std::forward<Range>(rhs));
+    const profile::stage* stage = views::detail::find_stage(source);
+
+    return views::detail::probe_result(
+      std::invoke(std::forward<Func>(lhs), std::forward<decltype(source)>(source)),
+      stage);
+#else
     return std::invoke(std::forward<Func>(lhs), std::forward<Range>(rhs));
+#endif
 }
 
-template<class Func, class Funk>
-constexpr auto
+template<class Funk, class Func>
+requires(!ForwardRange<Funk> && std::is_class_v<std::remove_cvref_t<Funk>> &&
+         std::is_class_v<std::remove_cvref_t<Func>>) constexpr auto
 operator|(Funk&& rhs, Func&& lhs)
 {
-    return [&]<class... Args>(Args && ... args)
+    return [rhs = std::forward<Funk>(rhs),
+            lhs = std::forward<Func>(lhs)]<class... Args>(Args && ... args)
     {
-        return std::invoke(
-          std::forward<Funk>(rhs),
-          std::invoke(std::forward<Func>(lhs), std::forward<Args>(args)...));
+        return std::invoke(lhs, std::invoke(rhs, std::forward<Args>(args)...));
     };
 }
 
 } // namespace itertools
-#endif // RANGE_CONTAINER_H
\ No newline at end of file
+
+#ifdef ITERTOOLS_PROFILE_ALL
+#include "itertools/views/probe.hpp"
+#endif
+
+#endif // RANGE_CONTAINER_H
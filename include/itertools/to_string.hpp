@@ -1,167 +1,161 @@
-#include "itertools.hpp"
-#include "tupletools.hpp"
+#include "fmt/format.h"
+
+#include "itertools/tupletools.hpp"
+#include "itertools/types.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <tuple>
 
 #pragma once
 
 namespace itertools {
 namespace detail {
 
-using namespace std::string_literals;
 using namespace tupletools;
 
-struct get_ndim_impl
-{
-    int ndim = 0;
-
-    template<Rangeable Iter>
-    constexpr void recurse(Iter&& iter)
-    {
-        ndim = 0;
-        recurse(*(++iter.begin()));
-        ndim += 1;
-    }
-
-    template<Tupleoid Tup>
-    constexpr void recurse(Tup&& tup)
-    {
-        for_each(tup, [this]<class T>(auto&& n, T&& i) {
-            recurse(std::forward<T>(i));
-        });
-        ndim += 1;
-    }
-
-    template<class T>
-    requires(!Rangeloid<T>) constexpr void recurse(T&& x)
-    {}
-
-    template<class Iter>
-    constexpr int operator()(Iter&& iter)
-    {
-        recurse(std::forward<Iter>(iter));
-        return ndim;
-    }
-};
-
-template<class Iter>
+/*
+How deeply T nests, known from its type alone: 0 for a scalar (strings included),
+and otherwise one more than the deepest of its elements.
+ */
+template<class T>
 constexpr int
-get_ndim(Iter&& iter)
+depth()
 {
-    return detail::get_ndim_impl{}(std::forward<Iter>(iter));
+    using U = std::remove_cvref_t<T>;
+
+    if constexpr (std::is_convertible_v<const U&, std::string_view>) {
+        return 0;
+    } else if constexpr (Tupleoid<U>) {
+        return []<std::size_t... Is>(std::index_sequence<Is...>) {
+            return 1 + std::max({ 0, depth<std::tuple_element_t<Is, U>>()... });
+        }(std::make_index_sequence<std::tuple_size_v<U>>{});
+    } else if constexpr (Rangeable<U>) {
+        return 1 + depth<range_value_t<U&>>();
+    } else {
+        return 0;
+    }
 }
 
-template<class Formatter>
-struct to_string_impl
+/*
+Streams ranges and tuples, nested to any depth, to an output iterator, numpy style:
+a nested element begins on a new line (or, for deeper nestings, after a blank
+line or more), indented to its opening bracket. Scalars are written by "write",
+called with the output iterator and the scalar, and returning the advanced
+iterator.
+ */
+template<class Out, class Write>
+struct string_writer
 {
+    Out out;
+    Write& write;
+    std::string_view sep;
 
-    Formatter formatter;
-    int ndim;
-    int offset;
-    std::string sep;
-    std::string tmp;
-
-    template<class Iter>
-    explicit to_string_impl(
-        Iter&& iter,
-        Formatter&& formatter,
-        std::string& sep,
-        int offset = 0)
-      : formatter{formatter}
-      , sep{sep}
-      , ndim{std::max(0, get_ndim(iter) - 1)}
-      , offset{offset} {};
-
-    template<class Iter>
-    std::string operator()(Iter&& iter)
-    {
-        return recurse(std::forward<Iter>(iter), 0);
-    }
-
-    decltype(auto) create_hanging_indent(int ix)
-    {
-        auto space_count = ndim > 0 ? std::max(0, ix + offset + 1) : 0;
-        std::string spaces(space_count, ' ');
-
-        std::string new_lines(std::max(0, ndim - ix), '\n');
-
-        return new_lines + spaces;
-    }
+    void put(std::string_view s) { out = std::copy(s.begin(), s.end(), out); }
 
+    // The separator before an element of a container nested "level" deep.
     template<class T>
-    requires(!Rangeloid<T>) std::string recurse(T&& x, int ix)
+    void separate(int level)
     {
-        return formatter(std::forward<T>(x));
+        if constexpr (depth<T>() > 0) {
+            auto trimmed = sep.substr(0, sep.find_last_not_of(' ') + 1);
+            put(trimmed);
+            out = std::fill_n(out, depth<T>(), '\n');
+            out = std::fill_n(out, level + 1, ' ');
+        } else {
+            put(sep);
+        }
     }
 
-    template<Tupleoid Tup>
-    std::string recurse(Tup tup, int ix)
+    template<class T>
+    void operator()(T&& x, int level = 0)
     {
-        std::string buff = "";
-        auto hanging_indent = create_hanging_indent(ix);
-
-        auto size = tuple_size_v<Tup>;
-        for_each(std::forward<Tup>(tup), [&, this]<class T>(auto n, T&& i) {
-            auto t_buff = to_string_impl{
-                std::forward<T>(i),
-                std::forward<Formatter>(formatter),
-                sep,
-                ix + 1}(std::forward<T>(i));
-
-            buff += (n > 0) ? hanging_indent + t_buff : t_buff;
-
-            if (n < size - 1) {
-                buff += sep;
+        using U = std::remove_cvref_t<T>;
+
+        if constexpr (depth<U>() == 0) {
+            out = write(out, x);
+        } else if constexpr (Tupleoid<U>) {
+            put("(");
+            for_each(std::forward<T>(x), [&, this]<class V>(auto n, V&& y) {
+                if (n > 0) {
+                    separate<V>(level);
+                }
+                (*this)(std::forward<V>(y), level + 1);
+            });
+            put(")");
+        } else {
+            put("[");
+            bool first = true;
+            for (auto&& y : x) {
+                if (!first) {
+                    separate<decltype(y)>(level);
+                }
+                first = false;
+                (*this)(std::forward<decltype(y)>(y), level + 1);
             }
-        });
-
-        return "("s + buff + ")"s;
+            put("]");
+        }
     }
+};
 
-    template<Rangeable Iter>
-    std::string recurse(Iter&& iter, int ix)
-    {
-        std::string buff = "";
-        auto hanging_indent = create_hanging_indent(ix);
-
-        for (auto&& [n, i] : views::enumerate(iter)) {
-            using T = std::remove_cvref_t<decltype(i)>;
-
-            if constexpr (Rangeloid<T>) {
-                auto t_buff = recurse(i, ix + 1);
-
-                buff += (n > 0) ? hanging_indent + t_buff : t_buff;
-            } else {
-                buff += formatter(i);
-            }
-
-            if (n < iter.size() - 1) {
-                buff += sep;
-            }
-        };
+template<class Out, class Write, class T>
+Out
+write_string(Out out, T&& x, Write&& write, std::string_view sep)
+{
+    string_writer<Out, Write> writer{ out, write, sep };
+    writer(std::forward<T>(x));
+    return writer.out;
+}
 
-        return "["s + buff + "]"s;
-    };
-};
+constexpr auto format_scalar = []<class Out, class T>(Out out, const T& x) {
+    return fmt::format_to(out, "{}", x);
 };
 
-template<class Iter, class Formatter>
-std::string
-to_string_f(Iter&& iter, Formatter&& formatter, std::string sep = ", ")
+}
+
+/*
+Writes the string representation of a range or tuple, or any nesting of them, to
+"out", returning the advanced iterator. Elements are streamed straight from the
+range, which needn't be sized, or even multi-pass.
+ */
+template<class Out, class T>
+Out
+format_to(Out out, T&& x, std::string_view sep = ", ")
 {
-    return detail::to_string_impl{
-        std::forward<Iter>(iter), std::forward<Formatter>(formatter), sep}(iter);
+    return detail::write_string(out, std::forward<T>(x), detail::format_scalar, sep);
 }
 
-template<class Iter>
+// As to_string, with each scalar formatted by "formatter", returning a string.
+template<class T, class Formatter>
 std::string
-to_string(Iter&& iter)
+to_string_f(T&& x, Formatter&& formatter, std::string_view sep = ", ")
 {
-    std::string sep = ", ";
-    auto formatter = []<class T>(T&& s) -> std::string {
-        return fmt::format("{}", std::forward<T>(s));
+    fmt::memory_buffer buffer;
+    auto write = [&]<class Out, class U>(Out out, const U& y) {
+        auto s = std::invoke(formatter, y);
+        return std::copy(s.begin(), s.end(), out);
     };
+    detail::write_string(std::back_inserter(buffer), std::forward<T>(x), write, sep);
+    return fmt::to_string(buffer);
+}
+
+/*
+The string representation of a range or tuple, or any nesting of them, formatted
+into one buffer:
 
-    return detail::to_string_impl{std::forward<Iter>(iter), std::move(formatter), sep}(
-        std::forward<Iter>(iter));
+    to_string(std::vector<std::vector<int>>{ { 1, 2 }, { 3, 4 } })
+    == "[[1, 2],\n [3, 4]]"
+ */
+template<class T>
+std::string
+to_string(T&& x, std::string_view sep = ", ")
+{
+    fmt::memory_buffer buffer;
+    itertools::format_to(std::back_inserter(buffer), std::forward<T>(x), sep);
+    return fmt::to_string(buffer);
 }
 
-}
\ No newline at end of file
+}
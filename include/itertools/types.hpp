@@ -1,6 +1,7 @@
 #ifndef TYPES_H
 #define TYPES_H
 
+#include <functional>
 #include <tuple>
 #include <type_traits>
 
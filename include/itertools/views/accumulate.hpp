@@ -0,0 +1,317 @@
+#include "itertools/range_iterator.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
+
+#pragma once
+
+namespace itertools {
+namespace views {
+namespace detail {
+
+// Sums that scan adds up 4 at a time, exactly, as integers wrap. (64-bit lanes, 2
+// at a time, are no faster than one at a time.)
+template<class Op, class T>
+concept PrefixSum =
+  (std::same_as<Op, std::plus<>> || std::same_as<Op, std::plus<T>>)&&std::integral<T> &&
+  sizeof(T) == 4;
+
+/*
+Writes the running sums of in[0, n), plus "carry", to out, returning the last. Each
+vector's prefix sum is taken in register, by two shifted adds, and the carry
+broadcast from its last lane to the next.
+ */
+template<class T>
+inline T
+prefix_sum(const T* in, T* out, std::size_t n, T carry)
+{
+    std::size_t i = 0;
+#ifdef __SSE2__
+    auto c = _mm_set1_epi32(static_cast<int>(carry));
+    for (; i + 4 <= n; i += 4) {
+        auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+        x = _mm_add_epi32(x, c);
+        c = _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), x);
+    }
+    if (i > 0) {
+        carry = out[i - 1];
+    }
+#endif
+    using U = std::make_unsigned_t<T>;
+    for (; i < n; ++i) {
+        carry = static_cast<T>(static_cast<U>(carry) + static_cast<U>(in[i]));
+        out[i] = carry;
+    }
+    return carry;
+}
+
+/*
+Writes op(... op(op(acc, first[0]), first[1]) ..., first[i]) to each out[i], i < n,
+returning the last; by prefix_sum when that's what op is.
+ */
+template<class Iter, class T, class Op>
+T
+scan_into(Iter first, std::size_t n, T* out, Op& op, T acc)
+{
+    if constexpr (PrefixSum<Op, T> && std::contiguous_iterator<Iter> &&
+                  std::same_as<std::iter_value_t<Iter>, T>) {
+        return prefix_sum(std::to_address(first), out, n, acc);
+    } else {
+        for (std::size_t i = 0; i < n; ++i, ++first) {
+            acc = std::invoke(op, std::move(acc), *first);
+            out[i] = acc;
+        }
+        return acc;
+    }
+}
+
+}
+
+/*
+The running results of a binary operation, by default +, over a range: Python's
+itertools.accumulate. x, op(x, y), op(op(x, y), z), ... for [x, y, z]; with an
+initial value, init comes first and is folded into all that follow, so that there's
+one more result than elements. Values are computed as the range is traversed and
+yielded by value.
+ */
+template<class Op, class T, bool HasInit, class Range>
+class accumulate_container
+  : public std::ranges::view_interface<accumulate_container<Op, T, HasInit, Range>>
+{
+    using iter_t = view_iterator_t<Range>;
+
+  public:
+    class iterator
+    {
+      public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::conditional_t<std::forward_iterator<iter_t>,
+                                                    std::forward_iterator_tag,
+                                                    std::input_iterator_tag>;
+
+        iterator() = default;
+
+        iterator(accumulate_container* base, iter_t it)
+          : base(base)
+          , it(std::move(it))
+        {
+            if constexpr (HasInit) {
+                value = *base->init;
+            } else if (this->it != std::ranges::end(base->range)) {
+                value.emplace(*this->it);
+            }
+        }
+
+        T operator*() const { return *value; }
+
+        iterator& operator++()
+        {
+            auto end = std::ranges::end(base->range);
+            if constexpr (HasInit) {
+                if (it == end) {
+                    past = true;
+                } else {
+                    value = std::invoke(*base->op, std::move(*value), *it);
+                    ++it;
+                }
+            } else if (++it != end) {
+                value = std::invoke(*base->op, std::move(*value), *it);
+            }
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const iterator& rhs) const
+        {
+            return it == rhs.it && past == rhs.past;
+        }
+
+        bool operator==(std::default_sentinel_t) const
+        {
+            return it == std::ranges::end(base->range) && (past || !HasInit);
+        }
+
+      private:
+        accumulate_container* base = nullptr;
+        iter_t it{};
+        std::optional<T> value;
+        // With an initial value, the last result's also at the range's end.
+        bool past = false;
+    };
+
+    view_t<Range> range;
+    movable_box<Op> op;
+    std::optional<T> init;
+
+    accumulate_container(Op&& op, std::optional<T> init, Range&& range)
+      : range(to_view(std::forward<Range>(range)))
+      , op(std::forward<Op>(op))
+      , init(std::move(init))
+    {}
+
+    auto begin() { return iterator(this, std::ranges::begin(range)); }
+
+    auto end() { return std::default_sentinel; }
+
+    auto size() requires std::ranges::sized_range<view_t<Range>>
+    {
+        return std::ranges::size(range) + HasInit;
+    }
+};
+
+namespace detail {
+template<class T, bool HasInit, class Op, class Range>
+constexpr auto
+accumulate(Op op, std::optional<T> init, Range&& range)
+{
+    return accumulate_container<Op, T, HasInit, Range>(
+      std::move(op), std::move(init), std::forward<Range>(range));
+}
+
+/*
+A range of ranges that hands them out whole, as flatten does, by segments(); here,
+ranges that are sized and random access.
+ */
+template<class Range>
+concept Segmented = requires(Range& range)
+{
+    requires std::ranges::input_range<decltype(range.segments())>;
+    requires std::ranges::random_access_range<
+      std::ranges::range_reference_t<decltype(range.segments())>>;
+    requires std::ranges::sized_range<
+      std::ranges::range_reference_t<decltype(range.segments())>>;
+};
+
+// scan, of a Segmented range: scan_into over each segment, appended to ret.
+template<bool HasInit, class T, class Op, class Segments>
+void
+scan_segments(std::vector<T>& ret, Op& op, std::optional<T> acc, Segments& segments)
+{
+    if constexpr (std::ranges::forward_range<Segments>) {
+        std::size_t total = HasInit;
+        for (auto&& segment : segments) {
+            total += static_cast<std::size_t>(std::ranges::size(segment));
+        }
+        ret.reserve(total);
+    }
+    if constexpr (HasInit) {
+        ret.push_back(*acc);
+    }
+    for (auto&& segment : segments) {
+        auto n = static_cast<std::size_t>(std::ranges::size(segment));
+        auto first = std::ranges::begin(segment);
+        if (n == 0) {
+            continue;
+        }
+        if (!acc) {
+            acc = *first;
+            ret.push_back(*acc);
+            ++first;
+            --n;
+        }
+        auto at = ret.size();
+        ret.resize(at + n);
+        acc = detail::scan_into(first, n, ret.data() + at, op, std::move(*acc));
+    }
+}
+
+/*
+Everything accumulate would yield, at once, into a std::vector. A sized, random
+access range is written in place, by scan_into: contiguous 32-bit integers summed
+SIMD, four at a time. So is each sized, random access segment of a Segmented range,
+the running value carried from one to the next.
+ */
+template<class T, bool HasInit, class Op, class Range>
+std::vector<T>
+scan(Op& op, std::optional<T> init, Range&& range)
+{
+    std::vector<T> ret;
+    if constexpr (std::ranges::random_access_range<Range> &&
+                  std::ranges::sized_range<Range>) {
+        auto n = static_cast<std::size_t>(std::ranges::size(range));
+        auto first = std::ranges::begin(range);
+        if constexpr (HasInit) {
+            ret.resize(n + 1);
+            ret[0] = *init;
+            detail::scan_into(first, n, ret.data() + 1, op, *init);
+        } else if (n > 0) {
+            ret.resize(n);
+            ret[0] = *first;
+            detail::scan_into(first + 1, n - 1, ret.data() + 1, op, ret[0]);
+        }
+    } else if constexpr (Segmented<Range>) {
+        scan_segments<HasInit>(ret, op, std::move(init), range.segments());
+    } else {
+        for (auto&& x : detail::accumulate<T, HasInit>(op, init, range)) {
+            ret.push_back(std::forward<decltype(x)>(x));
+        }
+    }
+    return ret;
+}
+}
+
+// The running op, by default +, of a range's elements.
+template<class Op = std::plus<>>
+constexpr auto
+accumulate(Op&& op = {})
+{
+    return [op = std::forward<Op>(op)]<class Range>(Range&& range) {
+        using T = std::ranges::range_value_t<Range>;
+        return detail::accumulate<T, false>(
+          op, std::nullopt, std::forward<Range>(range));
+    };
+}
+
+// The running op of init and a range's elements, init first.
+template<class Op, class T>
+constexpr auto
+accumulate(Op&& op, T init)
+{
+    return [op = std::forward<Op>(op), init = std::move(init)]<class Range>(
+             Range&& range) {
+        return detail::accumulate<T, true>(
+          op, std::optional<T>(init), std::forward<Range>(range));
+    };
+}
+
+// A sink: accumulate's results, as a std::vector.
+template<class Op = std::plus<>>
+constexpr auto
+scan(Op&& op = {})
+{
+    return [op = std::forward<Op>(op)]<class Range>(Range&& range) mutable {
+        using T = std::ranges::range_value_t<Range>;
+        return detail::scan<T, false>(op, std::nullopt, std::forward<Range>(range));
+    };
+}
+
+template<class Op, class T>
+constexpr auto
+scan(Op&& op, T init)
+{
+    return [op = std::forward<Op>(op), init = std::move(init)]<class Range>(
+             Range&& range) mutable {
+        return detail::scan<T, true>(
+          op, std::optional<T>(init), std::forward<Range>(range));
+    };
+}
+
+}
+}
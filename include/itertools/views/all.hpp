@@ -1,16 +1,37 @@
+#include "accumulate.hpp"
 #include "block.hpp"
+#include "codec.hpp"
+#include "combinations.hpp"
+#include "compress.hpp"
 #include "concat.hpp"
+#include "count.hpp"
+#include "csv.hpp"
+#include "cycle.hpp"
 #include "enumerate.hpp"
 #include "filter.hpp"
 #include "flatten.hpp"
-// #include "intersperse.hpp"
-// #include "join.hpp"
+#include "group_by.hpp"
+#include "intersperse.hpp"
+#include "join.hpp"
 #include "drop_while.hpp"
 #include "iota.hpp"
+#include "mmap.hpp"
+#include "parse.hpp"
+#include "permutations.hpp"
+#include "probe.hpp"
+#include "product.hpp"
+#include "read_chunks.hpp"
+#include "repeat.hpp"
 #include "reverse.hpp"
+#include "selection.hpp"
 #include "slice.hpp"
+#include "snapshot.hpp"
+#include "split.hpp"
 #include "stride.hpp"
+#include "take_while.hpp"
+#include "tee.hpp"
 #include "transform.hpp"
 #include "zip.hpp"
+#include "zip_longest.hpp"
 
 #pragma once
@@ -2,6 +2,8 @@
 #include "itertools/range_iterator.hpp"
 #include "itertools/tupletools.hpp"
 
+#include <vector>
+
 #pragma once
 
 namespace itertools {
@@ -9,69 +11,126 @@ namespace views {
 
 namespace detail {
 
+/*
+Splits a range into consecutive blocks of block_size elements, the last of which
+may be shorter. An iterator sits at the first element of its block; "missing" is
+how far short of a full block_size the last step forward fell, so that stepping
+back from the end lands on the start of the final, partial block.
+ */
 template<class Range>
-class block_container : public cached_container<Range>
+class block_container : public std::ranges::view_interface<block_container<Range>>
 {
   public:
     template<class Iter>
-    class iterator : public range_iterator<Iter>
+    class iterator : public range_iterator<Iter, iterator<Iter>>
     {
-        block_container* base;
-        using value_t = std::remove_cvref_t<tupletools::range_value_t<Range>>;
-        std::vector<value_t> ret;
+        using base_t = range_iterator<Iter, iterator<Iter>>;
+
+        constexpr auto end_of() const { return std::ranges::end(base->range); }
 
       public:
-        iterator(block_container* base, Iter&& it) noexcept
-          : range_iterator<Iter>(std::forward<Iter>(it))
+        using value_t = std::remove_cvref_t<std::iter_reference_t<Iter>>;
+        using value_type = std::vector<value_t>;
+        using difference_type = typename base_t::difference_type;
+
+        using base_t::operator++;
+        using base_t::operator--;
+        using base_t::operator-;
+
+        block_container* base = nullptr;
+        difference_type missing = 0;
+
+        iterator() = default;
+
+        iterator(block_container* base, Iter it, difference_type missing = 0)
+          : base_t(std::move(it))
           , base(base)
+          , missing(missing)
+        {}
+
+        value_type operator*() const
         {
+            auto n = static_cast<difference_type>(base->block_size);
+            auto last = std::ranges::next(this->it, n, end_of());
+
+            value_type ret;
             ret.reserve(base->block_size);
+            for (auto it = this->it; it != last; ++it) {
+                ret.push_back(*it);
+            }
+            return ret;
         }
 
-        bool is_complete() { return *base->begin_ == *base->end_; }
+        iterator& operator++()
+        {
+            auto n = static_cast<difference_type>(base->block_size);
+            missing = std::ranges::advance(this->it, n, end_of());
+            return *this;
+        }
 
-        auto operator++()
+        iterator& operator--()
         {
-            for (auto i : views::iota(ret.size())) {
-                ret.pop_back();
-            }
+            auto n = static_cast<difference_type>(base->block_size);
+            std::ranges::advance(this->it, missing - n);
+            missing = 0;
             return *this;
         }
 
-        auto operator*() noexcept
+        iterator& operator+=(difference_type x)
         {
-            for (auto i : views::iota(base->block_size)) {
-                if (is_complete()) {
-                    break;
-                } else {
-                    auto val = *this->it;
-                    ret.push_back(val);
-                    ++this->it;
-                }
+            auto n = static_cast<difference_type>(base->block_size);
+            if (x > 0) {
+                missing = std::ranges::advance(this->it, n * x, end_of());
+            } else if (x < 0) {
+                std::ranges::advance(this->it, n * x + missing);
+                missing = 0;
             }
-            return ret;
+            return *this;
+        }
+
+        difference_type operator-(const iterator& rhs) const
+          requires std::sized_sentinel_for<Iter, Iter>
+        {
+            auto n = static_cast<difference_type>(base->block_size);
+            return (this->it - rhs.it + missing - rhs.missing) / n;
         }
     };
 
-    template<class Iter>
-    iterator(block_container*, Iter&&) -> iterator<Iter>;
+    using iterator_t = iterator<view_iterator_t<Range>>;
 
+    view_t<Range> range;
     size_t block_size;
 
     block_container(Range&& range, size_t block_size)
-      : cached_container<Range>{ std::forward<Range>(range) }
+      : range{ to_view(std::forward<Range>(range)) }
       , block_size(block_size)
     {}
 
-    void init_begin() override { this->begin_ = std::begin(this->range); };
-    void init_end() override { this->end_ = std::end(this->range); };
+    auto begin() { return iterator_t(this, std::ranges::begin(range)); }
+
+    auto end()
+    {
+        if constexpr (std::ranges::common_range<view_t<Range>> &&
+                      std::ranges::sized_range<view_t<Range>>) {
+            auto size = std::ranges::distance(range);
+            auto missing = (static_cast<std::ptrdiff_t>(block_size) -
+                            size % static_cast<std::ptrdiff_t>(block_size)) %
+                           static_cast<std::ptrdiff_t>(block_size);
+            return iterator_t(this, std::ranges::end(range), missing);
+        } else {
+            return range_sentinel(std::ranges::end(range));
+        }
+    }
 
-    auto begin() { return iterator(this, this->cache_begin()); }
-    auto end() { return iterator(this, this->cache_end()); }
+    auto size() requires std::ranges::sized_range<view_t<Range>>
+    {
+        auto size = std::ranges::size(range);
+        return (size + block_size - 1) / block_size;
+    }
 };
 
 template<class Range>
-block_container(Range&&) -> block_container<Range>;
+block_container(Range&&, size_t) -> block_container<Range>;
 
 template<class Range>
 constexpr block_container<Range>
@@ -90,4 +149,4 @@ block(size_t block_size)
 }
 
 }
-}
\ No newline at end of file
+}
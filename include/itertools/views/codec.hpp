@@ -0,0 +1,697 @@
+#include "itertools/range_iterator.hpp"
+#include "itertools/views/split.hpp"
+#include "itertools/views/transform.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#pragma once
+
+namespace itertools {
+namespace views {
+
+/*
+Maps signed integers to unsigned ones of the same width, small magnitudes to small
+values: 0, -1, 1, -2 ... to 0, 1, 2, 3 ...; so that deltas of either sign varint or
+bit-pack well. unzigzag is its inverse.
+ */
+constexpr auto
+zigzag()
+{
+    return views::transform([]<std::signed_integral T>(T x) {
+        using U = std::make_unsigned_t<T>;
+        return static_cast<U>((static_cast<U>(x) << 1) ^
+                              static_cast<U>(x >> (std::numeric_limits<T>::digits)));
+    });
+}
+
+constexpr auto
+unzigzag()
+{
+    return views::transform([]<std::unsigned_integral U>(U x) {
+        using T = std::make_signed_t<U>;
+        return static_cast<T>((x >> 1) ^ static_cast<U>(-static_cast<U>(x & 1)));
+    });
+}
+
+/*
+The differences between successive elements, the first taken from zero: 3, 1, 4
+for [3, 4, 8]; or, "Inverse", their running sum, undoing the first. Arithmetic is
+the elements' own, so an unsorted range of unsigned integers wraps around, and
+unwraps again.
+ */
+template<bool Inverse, class Range>
+class delta_container
+  : public std::ranges::view_interface<delta_container<Inverse, Range>>
+{
+  public:
+    template<class Iter>
+    class iterator : public range_iterator<Iter, iterator<Iter>>
+    {
+        using base_t = range_iterator<Iter, iterator<Iter>>;
+
+      public:
+        // Each element depends on those before it, so there's no stepping back.
+        using iterator_concept = std::conditional_t<std::forward_iterator<Iter>,
+                                                    std::forward_iterator_tag,
+                                                    std::input_iterator_tag>;
+
+        using value_type = std::remove_cvref_t<std::iter_reference_t<Iter>>;
+        using difference_type = typename base_t::difference_type;
+
+        using base_t::operator++;
+
+        // The element before this one, or, "Inverse", the sum so far.
+        value_type prev{};
+
+        iterator() = default;
+
+        iterator(Iter it)
+          : base_t(std::move(it))
+        {}
+
+        iterator& operator++()
+        {
+            if constexpr (Inverse) {
+                prev = static_cast<value_type>(prev + *this->it);
+            } else {
+                prev = *this->it;
+            }
+            ++this->it;
+            return *this;
+        }
+
+        value_type operator*() const
+        {
+            if constexpr (Inverse) {
+                return static_cast<value_type>(prev + *this->it);
+            } else {
+                return static_cast<value_type>(*this->it - prev);
+            }
+        }
+
+        bool operator==(const iterator& rhs) const { return this->it == rhs.it; }
+
+        // A view over this one may hold our range's own sentinel, unwrapped.
+        template<std::sentinel_for<Iter> Sent>
+        bool operator==(const Sent& end) const
+        {
+            return this->it == end;
+        }
+    };
+
+    using iterator_t = iterator<view_iterator_t<Range>>;
+
+    view_t<Range> range;
+
+    delta_container(Range&& range)
+      : range(to_view(std::forward<Range>(range)))
+    {}
+
+    auto begin() { return iterator_t(std::ranges::begin(range)); }
+
+    auto end()
+    {
+        if constexpr (std::ranges::common_range<view_t<Range>>) {
+            return iterator_t(std::ranges::end(range));
+        } else {
+            return range_sentinel(std::ranges::end(range));
+        }
+    }
+
+    auto size() requires std::ranges::sized_range<view_t<Range>>
+    {
+        return std::ranges::size(range);
+    }
+};
+
+namespace detail {
+template<bool Inverse, class Range>
+constexpr auto
+delta(Range&& range)
+{
+    return delta_container<Inverse, Range>(std::forward<Range>(range));
+}
+}
+
+constexpr auto
+delta()
+{
+    return []<class Range>(Range&& range) {
+        return detail::delta<false>(std::forward<Range>(range));
+    };
+}
+
+constexpr auto
+undelta()
+{
+    return []<class Range>(Range&& range) {
+        return detail::delta<true>(std::forward<Range>(range));
+    };
+}
+
+namespace detail {
+
+template<std::unsigned_integral U>
+void
+put_varint(std::vector<std::uint8_t>& out, U x)
+{
+    while (x >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(x | 0x80));
+        x >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(x));
+}
+
+}
+
+/*
+Encodes a range of integers as LEB128 varints, 7 bits to a byte, the high bit set
+on all but an integer's last byte, into one std::vector<std::uint8_t>. Negative
+integers take the full 10 bytes; zigzag them first.
+ */
+constexpr auto
+to_varint()
+{
+    return []<class Range>(Range&& range) {
+        using T = std::remove_cvref_t<std::ranges::range_reference_t<Range>>;
+        using U = std::make_unsigned_t<T>;
+
+        std::vector<std::uint8_t> ret;
+        if constexpr (std::ranges::sized_range<Range>) {
+            ret.reserve(std::ranges::size(range) * 2);
+        }
+        for (auto&& x : range) {
+            detail::put_varint(ret, static_cast<U>(x));
+        }
+        return ret;
+    };
+}
+
+/*
+Decodes the LEB128 varints of a contiguous range of bytes, as written by to_varint,
+into T's. A varint that's cut short, or too long for a T, throws
+std::invalid_argument.
+ */
+template<class T, class Range>
+class varint_container : public std::ranges::view_interface<varint_container<T, Range>>
+{
+    using U = std::make_unsigned_t<T>;
+
+  public:
+    class iterator
+    {
+      public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::forward_iterator_tag;
+
+        iterator() = default;
+
+        iterator(const std::uint8_t* p, const std::uint8_t* last)
+          : p(p)
+          , last(last)
+        {
+            decode();
+        }
+
+        T operator*() const { return value; }
+
+        iterator& operator++()
+        {
+            p = next;
+            decode();
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const iterator& rhs) const { return p == rhs.p; }
+
+        bool operator==(std::default_sentinel_t) const { return p == last; }
+
+      private:
+        void decode()
+        {
+            if (p == last) {
+                return;
+            }
+            // Most deltas are under 128.
+            if (*p < 0x80) {
+                value = static_cast<T>(*p);
+                next = p + 1;
+                return;
+            }
+
+            U x = 0;
+            int shift = 0;
+            auto q = p;
+            for (;; ++q) {
+                if (q == last || shift >= std::numeric_limits<U>::digits) {
+                    throw std::invalid_argument("varint: truncated or too long");
+                }
+                x |= static_cast<U>(static_cast<U>(*q & 0x7F) << shift);
+                shift += 7;
+                if (*q < 0x80) {
+                    break;
+                }
+            }
+            value = static_cast<T>(x);
+            next = q + 1;
+        }
+
+        const std::uint8_t* p = nullptr;
+        const std::uint8_t* next = nullptr;
+        const std::uint8_t* last = nullptr;
+        T value{};
+    };
+
+    view_t<Range> range;
+
+    varint_container(Range&& range)
+      : range(to_view(std::forward<Range>(range)))
+    {}
+
+    auto begin()
+    {
+        auto first = reinterpret_cast<const std::uint8_t*>(std::ranges::data(range));
+        return iterator(first, first + std::ranges::size(range));
+    }
+
+    auto end() { return std::default_sentinel; }
+};
+
+namespace detail {
+template<class T, ByteRange Range>
+constexpr auto
+varint(Range&& range)
+{
+    return varint_container<T, Range>(std::forward<Range>(range));
+}
+}
+
+template<std::integral T>
+constexpr auto
+varint()
+{
+    return []<class Range>(Range&& range) {
+        return detail::varint<T>(std::forward<Range>(range));
+    };
+}
+
+namespace detail {
+
+/*
+Bit-packing in the manner of Lemire and Boytsov's SIMD-BP128: a block of 128 32-bit
+offsets, each "Bits" wide, is laid out as 4 interleaved lanes, value i in lane i % 4,
+so that word k of every lane is one 128-bit vector and 4 values are unpacked at a
+time with the same shifts. A block takes 4 * Bits words.
+ */
+inline void
+pack_block(const std::uint32_t* in, int bits, std::uint32_t* out)
+{
+    if (bits == 0) {
+        return;
+    }
+    for (int j = 0; j < 32; ++j) {
+        int bit = j * bits;
+        int k = bit / 32, s = bit % 32;
+        for (int lane = 0; lane < 4; ++lane) {
+            auto x = in[4 * j + lane];
+            out[4 * k + lane] |= x << s;
+            if (s + bits > 32) {
+                out[4 * (k + 1) + lane] |= x >> (32 - s);
+            }
+        }
+    }
+}
+
+// The j-th 4 values; shifts and masks are constants, for each width's own code.
+template<int Bits, int J>
+inline void
+unpack_4(const std::uint32_t* in, std::uint32_t* out)
+{
+    constexpr int k = J * Bits / 32, s = J * Bits % 32;
+    constexpr std::uint32_t mask = Bits == 32 ? ~0U : (1U << Bits) - 1;
+
+#ifdef __SSE2__
+    auto load = [&](int k) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 4 * k));
+    };
+    auto v = _mm_srli_epi32(load(k), s);
+    if constexpr (s + Bits > 32) {
+        v = _mm_or_si128(v, _mm_slli_epi32(load(k + 1), 32 - s));
+    }
+    v = _mm_and_si128(v, _mm_set1_epi32(static_cast<int>(mask)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * J), v);
+#else
+    for (int lane = 0; lane < 4; ++lane) {
+        auto x = in[4 * k + lane] >> s;
+        if constexpr (s + Bits > 32) {
+            x |= in[4 * (k + 1) + lane] << (32 - s);
+        }
+        out[4 * J + lane] = x & mask;
+    }
+#endif
+}
+
+template<int Bits>
+void
+unpack_block(const std::uint32_t* in, std::uint32_t* out)
+{
+    if constexpr (Bits == 0) {
+        std::fill_n(out, 128, 0);
+    } else {
+        [&]<int... Js>(std::integer_sequence<int, Js...>) {
+            (unpack_4<Bits, Js>(in, out), ...);
+        }(std::make_integer_sequence<int, 32>{});
+    }
+}
+
+using unpack_block_t = void (*)(const std::uint32_t*, std::uint32_t*);
+
+// unpack_block for each width, 0 to 32.
+inline constexpr auto block_unpackers =
+  []<int... Bits>(std::integer_sequence<int, Bits...>) {
+      return std::array<unpack_block_t, 33>{ &unpack_block<Bits>... };
+  }(std::make_integer_sequence<int, 33>{});
+
+}
+
+/*
+Integers compressed by frame of reference: each block of 128 is stored as its
+minimum and the offsets of its values from it, bit-packed (see detail::pack_block)
+as wide as the largest needs. Sorted IDs, or timestamps, delta encoded first, take a
+few bits apiece. A block whose offsets don't fit 32 bits is stored as is.
+ */
+template<std::integral T>
+class bitpacked
+{
+    using U = std::make_unsigned_t<T>;
+
+  public:
+    using value_type = T;
+
+    static constexpr std::size_t block_size = 128;
+
+    bitpacked() = default;
+
+    template<std::ranges::input_range Range>
+    explicit bitpacked(Range&& range)
+    {
+        if constexpr (std::ranges::sized_range<Range>) {
+            headers.reserve(std::ranges::size(range) / block_size + 1);
+        }
+
+        std::array<T, block_size> block;
+        std::size_t count = 0;
+        for (auto&& x : range) {
+            block[count++] = x;
+            if (count == block_size) {
+                push_block(block.data(), count);
+                count = 0;
+            }
+        }
+        if (count > 0) {
+            push_block(block.data(), count);
+        }
+    }
+
+    std::size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+
+    std::size_t blocks() const { return headers.size(); }
+
+    // The memory taken by the encoding, block headers included.
+    std::size_t bytes() const
+    {
+        return headers.size() * sizeof(block_header) +
+               words.size() * sizeof(std::uint32_t);
+    }
+
+    /*
+    Decodes the i-th block into "out", returning its length: block_size, or, for the
+    last, perhaps fewer.
+     */
+    std::size_t unpack(std::size_t i, std::span<T, block_size> out) const
+    {
+        const auto& header = headers[i];
+        auto count = i + 1 < headers.size() ? block_size : n - i * block_size;
+        auto in = words.data() + header.offset;
+
+        if (header.bits == raw_bits) {
+            std::memcpy(out.data(), in, count * sizeof(T));
+            return count;
+        }
+
+        alignas(16) std::array<std::uint32_t, block_size> offsets;
+        detail::block_unpackers[header.bits](in, offsets.data());
+
+        auto reference = static_cast<U>(header.reference);
+        for (std::size_t j = 0; j < count; ++j) {
+            out[j] = static_cast<T>(reference + offsets[j]);
+        }
+        return count;
+    }
+
+  private:
+    static constexpr std::uint8_t raw_bits = 0xFF;
+
+    struct block_header
+    {
+        T reference;
+        std::uint32_t offset;
+        std::uint8_t bits;
+    };
+
+    void push_block(const T* values, std::size_t count)
+    {
+        auto [min, max] = std::minmax_element(values, values + count);
+        auto range = static_cast<U>(static_cast<U>(*max) - static_cast<U>(*min));
+
+        auto offset = words.size();
+        if (offset > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error("bitpacked: too many values");
+        }
+
+        if (range > std::numeric_limits<std::uint32_t>::max()) {
+            headers.push_back({ *min, static_cast<std::uint32_t>(offset), raw_bits });
+            words.resize(offset + (count * sizeof(T) + 3) / 4);
+            std::memcpy(words.data() + offset, values, count * sizeof(T));
+        } else {
+            auto bits = std::bit_width(static_cast<std::uint32_t>(range));
+            headers.push_back({ *min,
+                                static_cast<std::uint32_t>(offset),
+                                static_cast<std::uint8_t>(bits) });
+
+            std::array<std::uint32_t, block_size> offsets{};
+            for (std::size_t j = 0; j < count; ++j) {
+                offsets[j] = static_cast<std::uint32_t>(static_cast<U>(values[j]) -
+                                                        static_cast<U>(*min));
+            }
+            words.resize(offset + 4 * static_cast<std::size_t>(bits));
+            detail::pack_block(offsets.data(), bits, words.data() + offset);
+        }
+        n += count;
+    }
+
+    std::vector<block_header> headers;
+    std::vector<std::uint32_t> words;
+    std::size_t n = 0;
+};
+
+// Encodes a range of integers as a bitpacked.
+constexpr auto
+to_bitpacked()
+{
+    return []<class Range>(Range&& range) {
+        using T = std::remove_cvref_t<std::ranges::range_reference_t<Range>>;
+        return bitpacked<T>(std::forward<Range>(range));
+    };
+}
+
+/*
+Decodes a bitpacked (kept by pointer if an lvalue, and moved in otherwise) a block
+at a time, into a buffer held by the iterator, so that only one block of 128 is ever
+decompressed: "Blocks", as std::span<const T>s of the block, just as
+views::block(128) would cut them, and otherwise as the values themselves.
+ */
+template<bool Blocks, class Packed>
+class unpack_container
+  : public std::ranges::view_interface<unpack_container<Blocks, Packed>>
+{
+    using packed_t = std::remove_cvref_t<Packed>;
+    using T = typename packed_t::value_type;
+
+  public:
+    class iterator
+    {
+      public:
+        using value_type = std::conditional_t<Blocks, std::span<const T>, T>;
+        using difference_type = std::ptrdiff_t;
+        // A block's span is into the iterator itself.
+        using iterator_concept = std::
+          conditional_t<Blocks, std::input_iterator_tag, std::forward_iterator_tag>;
+
+        iterator() = default;
+
+        iterator(const packed_t* packed)
+          : packed(packed)
+        {
+            if (!packed->empty()) {
+                fill();
+            }
+        }
+
+        // The positions are kept as pointers into the buffer, and so moved with it.
+        iterator(const iterator& rhs) { *this = rhs; }
+
+        iterator& operator=(const iterator& rhs)
+        {
+            packed = rhs.packed;
+            block = rhs.block;
+            buffer = rhs.buffer;
+            p = buffer.data() + (rhs.p - rhs.buffer.data());
+            last = buffer.data() + (rhs.last - rhs.buffer.data());
+            return *this;
+        }
+
+        value_type operator*() const
+        {
+            if constexpr (Blocks) {
+                return { p, last };
+            } else {
+                return *p;
+            }
+        }
+
+        iterator& operator++()
+        {
+            if (Blocks || ++p == last) {
+                if (++block < packed->blocks()) {
+                    fill();
+                } else {
+                    p = last;
+                }
+            }
+            return *this;
+        }
+
+        auto operator++(int)
+        {
+            if constexpr (Blocks) {
+                ++*this;
+            } else {
+                auto tmp = *this;
+                ++*this;
+                return tmp;
+            }
+        }
+
+        bool operator==(const iterator& rhs) const
+        {
+            return block == rhs.block &&
+                   p - buffer.data() == rhs.p - rhs.buffer.data();
+        }
+
+        bool operator==(std::default_sentinel_t) const { return p == last; }
+
+      private:
+        void fill()
+        {
+            p = buffer.data();
+            last = p + packed->unpack(block, buffer);
+        }
+
+        const packed_t* packed = nullptr;
+        std::size_t block = 0;
+        const T* p = nullptr;
+        const T* last = nullptr;
+        alignas(16) std::array<T, packed_t::block_size> buffer;
+    };
+
+    std::conditional_t<std::is_lvalue_reference_v<Packed>, const packed_t*, packed_t>
+      packed;
+
+    unpack_container(Packed&& packed)
+      : packed(init(std::forward<Packed>(packed)))
+    {}
+
+    auto begin() const { return iterator(&get()); }
+
+    auto end() const { return std::default_sentinel; }
+
+    std::size_t size() const { return Blocks ? get().blocks() : get().size(); }
+
+  private:
+    static auto init(Packed&& packed)
+    {
+        if constexpr (std::is_lvalue_reference_v<Packed>) {
+            return &packed;
+        } else {
+            return std::move(packed);
+        }
+    }
+
+    const packed_t& get() const
+    {
+        if constexpr (std::is_lvalue_reference_v<Packed>) {
+            return *packed;
+        } else {
+            return packed;
+        }
+    }
+};
+
+namespace detail {
+template<bool Blocks, class Packed>
+constexpr auto
+unpack(Packed&& packed)
+{
+    return unpack_container<Blocks, Packed>(std::forward<Packed>(packed));
+}
+}
+
+/*
+The values of a bitpacked, decoded a block at a time:
+
+    auto ids = sorted_ids | views::delta() | to_bitpacked();
+    for (auto id : views::unpack(ids) | views::undelta()) {
+        // ...
+    }
+ */
+template<class Packed>
+constexpr auto
+unpack(Packed&& packed)
+{
+    return detail::unpack<false>(std::forward<Packed>(packed));
+}
+
+// The blocks of a bitpacked, each decoded into a std::span<const T>.
+template<class Packed>
+constexpr auto
+unpack_blocks(Packed&& packed)
+{
+    return detail::unpack<true>(std::forward<Packed>(packed));
+}
+
+}
+}
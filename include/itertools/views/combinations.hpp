@@ -0,0 +1,369 @@
+#include "itertools/range_iterator.hpp"
+#include "itertools/views/selection.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#pragma once
+
+namespace itertools {
+namespace views {
+namespace detail {
+
+// C(n, k), throwing std::length_error if it doesn't fit a std::size_t.
+constexpr std::size_t
+binomial(std::size_t n, std::size_t k)
+{
+    if (k > n) {
+        return 0;
+    }
+    k = std::min(k, n - k);
+
+    unsigned __int128 ret = 1;
+    for (std::size_t i = 1; i <= k; ++i) {
+        ret = ret * (n - k + i) / i;
+        if (ret > std::numeric_limits<std::size_t>::max()) {
+            throw std::length_error("combinations: too many to count");
+        }
+    }
+    return static_cast<std::size_t>(ret);
+}
+
+}
+
+/*
+The r-combinations of a range's elements, in lexicographic order, each a selection
+of r of them; with replacement, an element may be chosen more than once. As with
+permutations, an iterator holds one buffer of positions, updated in place, and a
+selection is only good until its iterator's advanced.
+
+A combination with replacement of n elements, with each position's place added to
+it, is a combination without of m = n + r - 1. Every combination is then numbered
+in the combinatorial number system, so it + k unranks the k-th in O(m + r^2), and
+rank() gives any combination's number; either can split the work among threads.
+For n <= 64, combination_masks yields the subsets as bitmasks instead.
+ */
+template<bool Replacement, class Range>
+class combinations_container
+  : public std::ranges::view_interface<combinations_container<Replacement, Range>>
+{
+  public:
+    using range_t = detail::indexable_t<Range>;
+    using value_type = selection<std::ranges::iterator_t<range_t>>;
+
+    class iterator
+    {
+      public:
+        using value_type = combinations_container::value_type;
+        using difference_type = std::ptrdiff_t;
+        // A selection is of the iterator's own buffer.
+        using iterator_concept = std::forward_iterator_tag;
+
+        iterator() = default;
+
+        iterator(combinations_container* base, std::size_t rank)
+          : base(base)
+          , rank(rank)
+        {
+            if (rank < base->total) {
+                unrank();
+            }
+        }
+
+        value_type operator*() const
+        {
+            return { std::ranges::begin(base->range), { positions.data(), base->r } };
+        }
+
+        iterator& operator++()
+        {
+            if (++rank < base->total) {
+                step();
+            }
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        iterator& operator+=(difference_type k)
+        {
+            rank += static_cast<std::size_t>(k);
+            if (rank < base->total) {
+                unrank();
+            }
+            return *this;
+        }
+
+        iterator operator+(difference_type k) const
+        {
+            auto tmp = *this;
+            tmp += k;
+            return tmp;
+        }
+
+        difference_type operator-(const iterator& rhs) const
+        {
+            return static_cast<difference_type>(rank - rhs.rank);
+        }
+
+        bool operator==(const iterator& rhs) const { return rank == rhs.rank; }
+
+      private:
+        // The rightmost position that can still move up does; those after follow it.
+        void step()
+        {
+            auto n = base->n, r = base->r;
+            auto i = r - 1;
+            // Most steps only move the last.
+            if (positions[i] < n - 1) {
+                ++positions[i];
+                return;
+            }
+            if constexpr (Replacement) {
+                while (positions[i] == n - 1) {
+                    --i;
+                }
+                auto x = ++positions[i];
+                for (auto j = i + 1; j < r; ++j) {
+                    positions[j] = x;
+                }
+            } else {
+                while (positions[i] == n - r + i) {
+                    --i;
+                }
+                auto x = ++positions[i];
+                for (auto j = i + 1; j < r; ++j) {
+                    positions[j] = ++x;
+                }
+            }
+        }
+
+        /*
+        The rank-th combination. Counted from the last, a combination's number is
+        the sum of C(m - 1 - b_i, r - i) over its (strictly increasing) positions b:
+        each b_i is that which takes the largest such term left.
+         */
+        void unrank()
+        {
+            auto m = base->m, r = base->r;
+            positions.resize(r);
+
+            auto k = base->total - 1 - rank;
+            auto c = m;
+            for (std::size_t i = 0; i < r; ++i) {
+                auto t = r - i;
+                unsigned __int128 count = detail::binomial(--c, t);
+                while (count > k) {
+                    count = count * (c - t) / c;
+                    --c;
+                }
+                k -= static_cast<std::size_t>(count);
+
+                auto b = m - 1 - c;
+                positions[i] = b - (Replacement ? i : 0);
+            }
+        }
+
+        combinations_container* base = nullptr;
+        std::size_t rank = 0;
+        std::vector<std::size_t> positions;
+    };
+
+    range_t range;
+    std::size_t n = 0, r = 0;
+
+    combinations_container(Range&& range, std::size_t r)
+      : range(detail::indexable(std::forward<Range>(range)))
+      , n(std::ranges::size(this->range))
+      , r(r)
+      , m(Replacement && n > 0 && r > 0 ? n + r - 1 : n)
+      , total(detail::binomial(m, r))
+    {}
+
+    auto begin() { return iterator(this, 0); }
+
+    auto end() { return iterator(this, total); }
+
+    std::size_t size() const { return total; }
+
+    // The number of a combination of this range's, its position in the order.
+    std::size_t rank(const value_type& combination) const
+    {
+        auto positions = combination.indices();
+        std::size_t k = 0;
+        for (std::size_t i = 0; i < r; ++i) {
+            auto b = positions[i] + (Replacement ? i : 0);
+            k += detail::binomial(m - 1 - b, r - i);
+        }
+        return total - 1 - k;
+    }
+
+  private:
+    std::size_t m = 0;
+    std::size_t total = 0;
+};
+
+/*
+The r-element subsets of n <= 64 elements, as bitmasks: bit i for the i-th element.
+They're in increasing order, colexicographic rather than lexicographic, as Gosper's
+hack steps a mask to the next of as many bits in a handful of instructions; for
+subsets of features, say, that are wanted as masks rather than elements. The
+combinatorial number system ranks and unranks them, as it does combinations.
+ */
+class combination_masks_container
+  : public std::ranges::view_interface<combination_masks_container>
+{
+  public:
+    class iterator
+    {
+      public:
+        using value_type = std::uint64_t;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::forward_iterator_tag;
+
+        iterator() = default;
+
+        iterator(const combination_masks_container* base, std::size_t rank)
+          : base(base)
+          , rank(rank)
+        {
+            if (rank < base->total) {
+                unrank();
+            }
+        }
+
+        std::uint64_t operator*() const { return mask; }
+
+        iterator& operator++()
+        {
+            if (++rank < base->total) {
+                auto low = mask & -mask;
+                auto ripple = mask + low;
+                // Two shifts, not one by countr_zero + 2: for a lowest bit of 62,
+                // that's 64, past the width.
+                mask = ripple | (((mask ^ ripple) >> 2) >> std::countr_zero(low));
+            }
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        iterator& operator+=(difference_type k)
+        {
+            rank += static_cast<std::size_t>(k);
+            if (rank < base->total) {
+                unrank();
+            }
+            return *this;
+        }
+
+        iterator operator+(difference_type k) const
+        {
+            auto tmp = *this;
+            tmp += k;
+            return tmp;
+        }
+
+        difference_type operator-(const iterator& rhs) const
+        {
+            return static_cast<difference_type>(rank - rhs.rank);
+        }
+
+        bool operator==(const iterator& rhs) const { return rank == rhs.rank; }
+
+      private:
+        // A mask's number is the sum of C(b_i, i + 1) over its bits, lowest first.
+        void unrank()
+        {
+            mask = 0;
+            auto k = rank;
+            auto c = base->n;
+            for (auto i = base->r; i > 0; --i) {
+                unsigned __int128 count = detail::binomial(--c, i);
+                while (count > k) {
+                    count = count * (c - i) / c;
+                    --c;
+                }
+                k -= static_cast<std::size_t>(count);
+                mask |= std::uint64_t(1) << c;
+            }
+        }
+
+        const combination_masks_container* base = nullptr;
+        std::size_t rank = 0;
+        std::uint64_t mask = 0;
+    };
+
+    std::size_t n = 0, r = 0;
+
+    combination_masks_container(std::size_t n, std::size_t r)
+      : n(n)
+      , r(r)
+      , total(detail::binomial(n, r))
+    {
+        if (n > 64) {
+            throw std::invalid_argument("combination_masks: more than 64 elements");
+        }
+    }
+
+    auto begin() const { return iterator(this, 0); }
+
+    auto end() const { return iterator(this, total); }
+
+    std::size_t size() const { return total; }
+
+    // The number of a mask of r bits, its position in the order.
+    std::size_t rank(std::uint64_t mask) const
+    {
+        std::size_t k = 0;
+        for (std::size_t i = 1; mask != 0; ++i) {
+            auto bit = static_cast<std::size_t>(std::countr_zero(mask));
+            k += detail::binomial(bit, i);
+            mask &= mask - 1;
+        }
+        return k;
+    }
+
+  private:
+    std::size_t total = 0;
+};
+
+// The r-element subsets of a range's elements.
+template<class Range>
+constexpr auto
+combinations(Range&& range, std::size_t r)
+{
+    return combinations_container<false, Range>(std::forward<Range>(range), r);
+}
+
+// The r-element multisets of a range's elements.
+template<class Range>
+constexpr auto
+combinations_with_replacement(Range&& range, std::size_t r)
+{
+    return combinations_container<true, Range>(std::forward<Range>(range), r);
+}
+
+// The r-element subsets of n elements, as bitmasks.
+inline auto
+combination_masks(std::size_t n, std::size_t r)
+{
+    return combination_masks_container(n, r);
+}
+
+}
+}
@@ -0,0 +1,279 @@
+#include "itertools/range_iterator.hpp"
+
+#include <bit>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#pragma once
+
+namespace itertools {
+namespace views {
+namespace detail {
+
+template<class T>
+struct is_bitset : std::false_type
+{};
+
+template<std::size_t N>
+struct is_bitset<std::bitset<N>> : std::true_type
+{};
+
+/*
+How compress holds its selectors: a range as a view; a std::bitset, which isn't
+one, by reference if it's an lvalue and by value otherwise.
+ */
+template<class Selectors>
+constexpr auto
+hold_selectors(Selectors&& selectors)
+{
+    using T = std::remove_cvref_t<Selectors>;
+    if constexpr (!is_bitset<T>::value) {
+        return to_view(std::forward<Selectors>(selectors));
+    } else if constexpr (std::is_lvalue_reference_v<Selectors>) {
+        return std::cref(selectors);
+    } else {
+        return T(std::move(selectors));
+    }
+}
+
+/*
+Selectors whose set bits can be found a word at a time: a std::bitset, by its
+_Find_next, or a std::vector<bool>, by libstdc++'s words. Anything else is a range of
+values tested one by one.
+ */
+template<class T>
+inline constexpr bool is_bit_selectors = is_bitset<T>::value;
+
+#ifdef __GLIBCXX__
+template<>
+inline constexpr bool is_bit_selectors<std::vector<bool>> = true;
+#endif
+
+template<class Selectors>
+using selectors_t = decltype(hold_selectors(std::declval<Selectors>()));
+
+// A bit's index, for bit selectors; otherwise the selectors' iterator.
+template<class Held, bool Bits>
+struct selector_iterator
+{
+    using type = std::size_t;
+};
+
+template<class Held>
+struct selector_iterator<Held, false>
+{
+    using type = std::ranges::iterator_t<Held>;
+};
+
+// The first set bit of words[0, (n + 63) / 64) at or after "from", or n.
+inline std::size_t
+next_set_bit(const unsigned long* words, std::size_t n, std::size_t from)
+{
+    constexpr std::size_t bits = sizeof(unsigned long) * 8;
+    if (from >= n) {
+        return n;
+    }
+    auto w = from / bits;
+    auto word = words[w] & (~0UL << (from % bits));
+    auto last = (n - 1) / bits;
+    while (word == 0) {
+        if (++w > last) {
+            return n;
+        }
+        word = words[w];
+    }
+    return std::min(n, w * bits + static_cast<std::size_t>(std::countr_zero(word)));
+}
+
+}
+
+/*
+The elements of "data" whose selectors are true, in order, stopping at the shorter of
+the two: Python's itertools.compress.
+
+Selectors that are a std::bitset or a std::vector<bool> are scanned a word at a time,
+each next set bit found by a count of trailing zeros, so that runs of unselected
+elements cost a word compare per 64 of them, and the data iterator's advanced
+straight to the next selected element, in one step if it's random access.
+ */
+template<class Data, class Selectors>
+class compress_container
+  : public std::ranges::view_interface<compress_container<Data, Selectors>>
+{
+    using data_iter_t = view_iterator_t<Data>;
+    using held_t = detail::selectors_t<Selectors>;
+
+    static constexpr bool is_bits =
+      detail::is_bit_selectors<std::remove_cvref_t<Selectors>>;
+
+    using selector_iter_t = typename detail::selector_iterator<held_t, is_bits>::type;
+
+    static constexpr bool is_forward =
+      std::forward_iterator<data_iter_t> &&
+      (is_bits || std::forward_iterator<selector_iter_t>);
+
+  public:
+    class iterator
+    {
+      public:
+        using value_type = std::iter_value_t<data_iter_t>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::
+          conditional_t<is_forward, std::forward_iterator_tag, std::input_iterator_tag>;
+
+        iterator() = default;
+
+        iterator(compress_container* base, data_iter_t it, selector_iter_t selector)
+          : base(base)
+          , it(std::move(it))
+          , selector(std::move(selector))
+        {
+            if constexpr (is_bits) {
+                seek(base->next_bit(0));
+            } else {
+                skip();
+            }
+        }
+
+        decltype(auto) operator*() const { return *it; }
+
+        iterator& operator++()
+        {
+            if constexpr (is_bits) {
+                seek(base->next_bit(selector + 1));
+            } else {
+                ++it;
+                ++selector;
+                skip();
+            }
+            return *this;
+        }
+
+        void operator++(int) requires(!is_forward) { ++*this; }
+
+        iterator operator++(int) requires is_forward
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const iterator& rhs) const
+        {
+            return it == rhs.it && selector == rhs.selector;
+        }
+
+        bool operator==(std::default_sentinel_t) const { return done(); }
+
+      private:
+        bool done() const
+        {
+            if constexpr (is_bits) {
+                return selector >= base->bit_count;
+            } else {
+                return it == std::ranges::end(base->data) ||
+                       selector == std::ranges::end(base->selectors);
+            }
+        }
+
+        // Past the unselected elements.
+        void skip() requires(!is_bits)
+        {
+            while (!done() && !static_cast<bool>(*selector)) {
+                ++it;
+                ++selector;
+            }
+        }
+
+        // To the element at bit "next", or the end, if the data runs out first.
+        void seek(std::size_t next) requires is_bits
+        {
+            auto step = static_cast<std::ptrdiff_t>(next - selector);
+            if (next >= base->bit_count ||
+                std::ranges::advance(it, step, std::ranges::end(base->data)) != 0 ||
+                it == std::ranges::end(base->data)) {
+                selector = base->bit_count;
+            } else {
+                selector = next;
+            }
+        }
+
+        compress_container* base = nullptr;
+        data_iter_t it{};
+        // The selector's iterator, or, for bits, the bit's index.
+        selector_iter_t selector{};
+    };
+
+    view_t<Data> data;
+    held_t selectors;
+
+    compress_container(Data&& data, Selectors&& selectors)
+      : data(to_view(std::forward<Data>(data)))
+      , selectors(detail::hold_selectors(std::forward<Selectors>(selectors)))
+    {
+        if constexpr (is_bits) {
+            bit_count = bits().size();
+        }
+    }
+
+    auto begin()
+    {
+        if constexpr (is_bits) {
+            return iterator(this, std::ranges::begin(data), 0);
+        } else {
+            auto selector = std::ranges::begin(selectors);
+            return iterator(this, std::ranges::begin(data), std::move(selector));
+        }
+    }
+
+    auto end() { return std::default_sentinel; }
+
+  private:
+    decltype(auto) bits() const
+    {
+        if constexpr (detail::is_bitset<std::remove_cvref_t<Selectors>>::value) {
+            return static_cast<const std::unwrap_reference_t<held_t>&>(selectors);
+        } else {
+            return selectors.base();
+        }
+    }
+
+    // The first selected bit at or after "from", or bit_count.
+    std::size_t next_bit(std::size_t from) const requires is_bits
+    {
+        const auto& b = bits();
+        if constexpr (detail::is_bitset<std::remove_cvref_t<decltype(b)>>::value) {
+            if (from >= bit_count) {
+                return bit_count;
+            }
+#ifdef __GLIBCXX__
+            return from == 0 ? b._Find_first() : b._Find_next(from - 1);
+#else
+            while (from < bit_count && !b.test(from)) {
+                ++from;
+            }
+            return from;
+#endif
+        } else {
+            return detail::next_set_bit(b.begin()._M_p, bit_count, from);
+        }
+    }
+
+    std::size_t bit_count = 0;
+};
+
+// The elements of data whose selectors are true.
+template<class Data, class Selectors>
+constexpr auto
+compress(Data&& data, Selectors&& selectors)
+{
+    return compress_container<Data, Selectors>(std::forward<Data>(data),
+                                               std::forward<Selectors>(selectors));
+}
+
+}
+}
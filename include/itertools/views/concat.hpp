@@ -5,283 +5,204 @@
 #include "transform.hpp"
 #include "zip.hpp"
 
+#include <array>
+
 #pragma once
 
 namespace itertools {
 namespace views {
 namespace detail {
 
-template<class Range>
-using cached_tuple =
-  cached_container<Range, tuple_begin_t<Range&>, tuple_end_t<Range&>>;
-
-template<class Range>
-using tuple_iter_value_t =
-  std::remove_cvref_t<decltype(std::get<0>(std::declval<Range>()))>;
-template<class Range>
-class concat_container_tuple : public cached_tuple<Range>
+template<class View>
+using concat_concept_t = std::conditional_t<
+  std::ranges::random_access_range<View> && std::ranges::sized_range<View> &&
+    std::ranges::common_range<View>,
+  std::random_access_iterator_tag,
+  std::conditional_t<std::ranges::bidirectional_range<View> &&
+                       std::ranges::common_range<View>,
+                     std::bidirectional_iterator_tag,
+                     iterator_concept_t<std::ranges::iterator_t<View>>>>;
+
+/*
+Chains N ranges of the same type end to end. An iterator holds the index, "ix", of
+the range it is currently in alongside its position therein; it never rests at the
+end of any but the last range.
+ */
+template<class View, std::size_t N>
+class concat_container
+  : public std::ranges::view_interface<concat_container<View, N>>
 {
   public:
-    template<class Iter>
-    class iterator : range_iterator<Iter>
-    {
-      private:
-        template<int ix>
-        bool is_complete() const
-        {
-            return std::get<ix>(*base->begin_) == std::get<ix>(*base->end_);
-        }
+    using Iter = std::ranges::iterator_t<View>;
 
-        template<int ix>
-        bool roll()
-        {
-            tupletools::roll<ix == 0>(*base->begin_);
-            tupletools::roll<ix == 0>(*base->end_);
-            return is_complete<ix>();
-        }
+    class iterator : public range_iterator<Iter, iterator>
+    {
+        using base_t = range_iterator<Iter, iterator>;
 
-        template<int ix>
-        bool roll_if_complete()
-        {
-            if (is_complete<ix>()) {
-                rolled = true;
-                return this->roll<ix>();
-            } else {
-                rolled = false;
-                return false;
-            }
-        }
+        constexpr auto& range(std::size_t n) const { return base->ranges[n]; }
 
-        void advance(auto&& func)
+        constexpr void satisfy()
         {
-            if (is_reversed) {
-                func.template operator()<N - 1>(this);
-            } else {
-                func.template operator()<0>(this);
+            while (ix + 1 < N && this->it == std::ranges::end(range(ix))) {
+                ++ix;
+                this->it = std::ranges::begin(range(ix));
             }
         }
 
       public:
-        using value_t = tuple_iter_value_t<typename cached_tuple<Range>::begin_t>;
-        static constexpr int N = tupletools::tuple_size_v<Range>;
+        using iterator_concept = concat_concept_t<View>;
+        using difference_type = typename base_t::difference_type;
 
-        concat_container_tuple* base;
-        value_t value;
-        bool is_reversed;
-        bool rolled = false;
+        using base_t::operator++;
+        using base_t::operator--;
+        using base_t::operator-;
 
-        iterator(concat_container_tuple* base, Iter&& it, bool is_reversed = false)
-          : range_iterator<Iter>{ std::forward<Iter>(it) }
-          , base(base)
-          , value(std::get<0>(it))
-          , is_reversed(is_reversed)
-        {}
+        concat_container* base = nullptr;
+        std::size_t ix = 0;
 
-        template<class T>
-        bool operator==(const iterator<T>& rhs) const
-        {
-            if (is_reversed) {
-                return is_complete<N - 1>();
-            } else {
-                return is_complete<0>();
-            }
-        }
+        iterator() = default;
 
-        auto operator++() -> decltype(auto)
+        constexpr iterator(concat_container* base, std::size_t ix, Iter it)
+          : base_t(std::move(it))
+          , base(base)
+          , ix(ix)
         {
-            if (is_reversed && rolled) {
-                this->roll<0>();
-            }
-
-            constexpr auto func = []<int ix>(auto&& self) {
-                ++std::get<ix>(self->it);
-                self->template roll_if_complete<ix>();
-                self->value = std::get<ix>(self->it);
-            };
-
-            advance(func);
-            return *this;
+            satisfy();
         }
 
-        auto operator--() -> decltype(auto)
+        constexpr bool operator==(const iterator& rhs) const
         {
-            if (!is_reversed && rolled) {
-                this->roll<N - 1>();
-            }
-
-            constexpr auto func = []<int ix>(auto&& self) {
-                --std::get<ix>(self->it);
-                self->value = std::get<ix>(self->it);
-                self->template roll_if_complete<ix>();
-            };
-
-            advance(func);
-            return *this;
+            return ix == rhs.ix && this->it == rhs.it;
         }
 
-        auto operator*() -> decltype(auto) { return *value; }
-    };
-
-    template<class Iter>
-    iterator(concat_container_tuple*, Iter&&, bool = false) -> iterator<Iter>;
-
-    concat_container_tuple(Range&& range)
-      : cached_tuple<Range>{ std::forward<Range>(range) }
-    {}
-
-    void init_begin() override { this->begin_ = tuple_begin(this->range); }
-    void init_end() override { this->end_ = tuple_end(this->range); }
-
-    auto begin() { return iterator(this, this->cache_begin()); }
-    auto end() { return iterator(this, this->cache_end(), true); }
-};
-
-template<class Range>
-concat_container_tuple(Range&&) -> concat_container_tuple<Range>;
-
-auto vector_begin = [](auto&& range) {
-    return range | views::transform([](auto&& x) { return x.begin(); }) |
-           to<std::vector>();
-};
-
-auto vector_end = [](auto&& range) {
-    return range | views::transform([](auto&& x) { return x.end(); }) |
-           to<std::vector>();
-};
-
-template<class Range, class Value = range_value_t<Range>>
-using cached_vector = cached_container<Range,
-                                       std::vector<iter_begin_t<Value>>,
-                                       std::vector<iter_end_t<Value>>>;
-
-template<class Range>
-class concat_container_vector : public cached_vector<Range>
-{
-
-  public:
-    template<class Iter>
-    class iterator : range_iterator<Iter>
-    {
-      private:
-        bool is_complete() const
+        constexpr bool operator==(std::default_sentinel_t) const
         {
-            return (*base->begin_)[get_ix()] == (*base->end_)[get_ix()];
+            return ix + 1 == N && this->it == std::ranges::end(range(ix));
         }
 
-        bool roll(bool reverse = true)
+        constexpr std::weak_ordering operator<=>(const iterator& rhs) const
+          requires std::random_access_iterator<Iter>
         {
-            itertools::roll(*base->begin_, reverse);
-            itertools::roll(*base->end_, reverse);
-
-            return is_complete();
+            if (ix != rhs.ix) {
+                return ix <=> rhs.ix;
+            }
+            return base_t::operator<=>(rhs);
         }
 
-        bool roll_if_complete()
+        constexpr iterator& operator++()
         {
-            if (is_complete()) {
-                rolled = true;
-                return roll(!is_reversed);
-            } else {
-                rolled = false;
-                return false;
-            }
+            ++this->it;
+            satisfy();
+            return *this;
         }
 
-        auto get_ix() const { return is_reversed ? this->it.size() - 1 : 0; }
-
-        auto& first() { return this->it[get_ix()]; }
-
-      public:
-        using value_t = iter_begin_t<range_value_t<Range>>;
-
-        concat_container_vector* base;
-        value_t cached_value;
-        bool is_reversed;
-        bool rolled = false;
-
-        iterator(concat_container_vector* base, Iter&& it, bool is_reversed = false)
-          : range_iterator<Iter>{ std::forward<Iter>(it) }
-          , base(base)
-          , cached_value(it[0])
-          , is_reversed(is_reversed)
-        {}
-
-        template<class T>
-        bool operator==(const iterator<T>& rhs) const
+        constexpr iterator& operator--()
         {
-            return is_complete();
+            while (ix > 0 && this->it == std::ranges::begin(range(ix))) {
+                --ix;
+                this->it = std::ranges::end(range(ix));
+            }
+            --this->it;
+            return *this;
         }
 
-        auto operator++() -> decltype(auto)
+        constexpr iterator& operator+=(difference_type n)
         {
-            if (is_reversed && rolled) {
-                roll(true);
+            if (n > 0) {
+                while (true) {
+                    auto left = std::ranges::end(range(ix)) - this->it;
+                    if (n < left || ix + 1 == N) {
+                        this->it += n;
+                        break;
+                    }
+                    n -= left;
+                    this->it = std::ranges::begin(range(++ix));
+                }
+                satisfy();
+            } else if (n < 0) {
+                n = -n;
+                while (true) {
+                    auto before = this->it - std::ranges::begin(range(ix));
+                    if (n <= before || ix == 0) {
+                        this->it -= n;
+                        break;
+                    }
+                    n -= before;
+                    this->it = std::ranges::end(range(--ix));
+                }
             }
-
-            ++first();
-            roll_if_complete();
-            cached_value = first();
-
             return *this;
         }
 
-        auto operator--() -> decltype(auto)
+        constexpr difference_type operator-(const iterator& rhs) const
+          requires std::sized_sentinel_for<Iter, Iter>
         {
-            if (!is_reversed && rolled) {
-                roll(false);
+            if (ix < rhs.ix) {
+                return -(rhs - *this);
+            } else if (ix == rhs.ix) {
+                return this->it - rhs.it;
             }
 
-            --first();
-            cached_value = first();
-            roll_if_complete();
-
-            return *this;
+            difference_type n = std::ranges::end(range(rhs.ix)) - rhs.it;
+            for (auto i = rhs.ix + 1; i < ix; ++i) {
+                n += std::ranges::distance(range(i));
+            }
+            return n + (this->it - std::ranges::begin(range(ix)));
         }
 
-        auto operator*() -> decltype(auto) { return *cached_value; }
-        auto operator->() -> decltype(auto) { return cached_value; }
+        friend constexpr decltype(auto) iter_move(const iterator& i) noexcept(
+          noexcept(std::ranges::iter_move(i.it)))
+        {
+            return std::ranges::iter_move(i.it);
+        }
     };
 
-    template<class Iter>
-    iterator(concat_container_vector*, Iter&&, bool = false) -> iterator<Iter>;
+    std::array<View, N> ranges;
 
-    concat_container_vector(Range&& range)
-      : cached_vector<Range>{ std::forward<Range>(range) }
+    constexpr concat_container(std::array<View, N>&& ranges)
+      : ranges(std::move(ranges))
     {}
 
-    void init_begin() override { this->begin_ = vector_begin(this->range); }
-    void init_end() override { this->end_ = vector_end(this->range); }
+    auto begin() { return iterator(this, 0, std::ranges::begin(ranges[0])); }
 
-    auto begin() { return iterator(this, this->cache_begin()); }
-    auto end() { return iterator(this, this->cache_end(), true); }
-};
+    auto end()
+    {
+        if constexpr (std::ranges::common_range<View>) {
+            return iterator(this, N - 1, std::ranges::end(ranges[N - 1]));
+        } else {
+            return std::default_sentinel;
+        }
+    }
 
-template<class Range>
-concat_container_vector(Range&&) -> concat_container_vector<Range>;
+    auto size() requires std::ranges::sized_range<View>
+    {
+        std::size_t n = 0;
+        for (auto&& range : ranges) {
+            n += std::ranges::size(range);
+        }
+        return n;
+    }
+};
 
-template<class Range>
-concat_container_tuple<Range>
-concat(Range&& range)
+template<class T, class... Args>
+constexpr auto
+concat(T&& arg, Args&&... args)
 {
-    return concat_container_tuple(std::forward<Range>(range));
+    using View = view_t<T>;
+    auto ranges = std::array<View, 1 + sizeof...(Args)>{
+        to_view(std::forward<T>(arg)), to_view(std::forward<Args>(args))...
+    };
+    return concat_container<View, 1 + sizeof...(Args)>(std::move(ranges));
 }
 
 }
 
 template<class T, class... Args>
-requires(std::is_same_v<T, Args>&&...) constexpr decltype(auto)
+requires(std::is_same_v<view_t<T>, view_t<Args>>&&...) constexpr decltype(auto)
   concat(T&& arg, Args&&... args)
 {
-    auto tup = std::forward_as_tuple(arg, args...);
-    return detail::concat(std::move(tup));
+    return detail::concat(std::forward<T>(arg), std::forward<Args>(args)...);
 }
 
-template<class Range>
-auto
-flatten(Range&& range)
-{
-    return detail::concat_container_vector(std::forward<Range>(range));
 }
-
 }
-}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include "itertools/range_iterator.hpp"
+#include "itertools/views/iota.hpp"
+
+#include <iterator>
+
+#pragma once
+
+namespace itertools {
+namespace views {
+
+/*
+start, start + step, start + 2 * step, ... without end: Python's itertools.count.
+The iterator is iota's, each element computed from its position rather than summed,
+so that floating steps don't drift. Its end is std::unreachable_sentinel: a loop over
+it has no exit test, and is to be cut short by a zip, a slice, or a break.
+ */
+template<class T = int>
+class count : public std::ranges::view_interface<count<T>>
+{
+  public:
+    using iterator = typename iota<T>::iterator;
+
+    constexpr explicit count(T start = 0, T step = 1)
+      : start(start)
+      , step(step)
+    {}
+
+    constexpr auto begin() const { return iterator(start, step, 0); }
+
+    constexpr auto end() const { return std::unreachable_sentinel; }
+
+    T start, step;
+};
+
+}
+}
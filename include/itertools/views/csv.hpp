@@ -0,0 +1,410 @@
+#include "itertools/range_iterator.hpp"
+#include "itertools/views/parse.hpp"
+#include "itertools/views/split.hpp"
+#include "itertools/views/transform.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#pragma once
+
+namespace itertools {
+namespace views {
+
+struct csv_options
+{
+    char sep = ',';
+    char quote = '"';
+};
+
+/*
+A row of at most N fields, as std::string_views into the input. A quoted field is
+given without its enclosing quotes, but any doubled quotes within are left as is.
+ */
+template<std::size_t N>
+class csv_row
+{
+  public:
+    auto begin() const { return fields.begin(); }
+    auto end() const { return fields.begin() + n; }
+
+    std::size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+
+    std::string_view operator[](std::size_t i) const { return fields[i]; }
+
+    /*
+    The i-th field, parsed as by views::parse; throws std::invalid_argument unless
+    the whole field is a T.
+     */
+    template<class T>
+    T get(std::size_t i) const
+    {
+        auto field = fields[i];
+        if constexpr (std::is_convertible_v<std::string_view, T>) {
+            return field;
+        } else {
+            auto value = detail::parse_number<T>(field);
+            if (!value) {
+                throw std::invalid_argument("csv: can't parse \"" + std::string(field) +
+                                            "\"");
+            }
+            return *value;
+        }
+    }
+
+    void push_back(std::string_view field)
+    {
+        if (n == N) {
+            throw std::length_error("csv: row has more than " + std::to_string(N) +
+                                    " fields");
+        }
+        fields[n++] = field;
+    }
+
+    void clear() { n = 0; }
+
+  private:
+    std::array<std::string_view, N> fields;
+    std::size_t n = 0;
+};
+
+namespace detail {
+
+/*
+Finds the separators and newlines that lie outside quotes, 32 bytes at a time, in
+the manner of simdjson: bitmasks of the block's quotes, separators and newlines are
+taken (with AVX2 or SSE2, if available), and the quotes' prefix xor masks out whatever
+they enclose. The quote state is carried from one block to the next.
+ */
+class csv_scanner
+{
+  public:
+    csv_scanner() = default;
+
+    csv_scanner(const char* first, const char* last, csv_options options)
+      : first(first)
+      , last(last)
+      , options(options)
+    {}
+
+    // The next separator or newline outside quotes, or last.
+    const char* next()
+    {
+        while (mask == 0) {
+            if (last - first <= offset) {
+                return last;
+            }
+            block = first + offset;
+            offset += 32;
+            mask = structurals();
+        }
+        auto i = __builtin_ctz(mask);
+        mask &= mask - 1;
+        return block + i;
+    }
+
+  private:
+    static std::uint32_t prefix_xor(std::uint32_t x)
+    {
+        x ^= x << 1;
+        x ^= x << 2;
+        x ^= x << 4;
+        x ^= x << 8;
+        x ^= x << 16;
+        return x;
+    }
+
+    std::uint32_t structurals()
+    {
+        std::uint32_t quotes, seps, newlines;
+
+        auto n = last - block;
+        const char* bytes = block;
+        alignas(32) char tail[32] = {};
+        if (n < 32) {
+            std::memcpy(tail, block, static_cast<std::size_t>(n));
+            bytes = tail;
+        }
+
+#ifdef __AVX2__
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes));
+        auto eq = [&](char c) {
+            return static_cast<std::uint32_t>(
+              _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(c))));
+        };
+        quotes = eq(options.quote);
+        seps = eq(options.sep);
+        newlines = eq('\n');
+#elif defined(__SSE2__)
+        // Two halves, with the SSE2 every x86-64 has.
+        auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+        auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 16));
+        auto eq = [&](char c) {
+            auto needle = _mm_set1_epi8(c);
+            auto mask_lo = _mm_movemask_epi8(_mm_cmpeq_epi8(lo, needle));
+            auto mask_hi = _mm_movemask_epi8(_mm_cmpeq_epi8(hi, needle));
+            return static_cast<std::uint32_t>(mask_lo | (mask_hi << 16));
+        };
+        quotes = eq(options.quote);
+        seps = eq(options.sep);
+        newlines = eq('\n');
+#else
+        quotes = seps = newlines = 0;
+        for (int i = 0; i < 32; ++i) {
+            quotes |= std::uint32_t(bytes[i] == options.quote) << i;
+            seps |= std::uint32_t(bytes[i] == options.sep) << i;
+            newlines |= std::uint32_t(bytes[i] == '\n') << i;
+        }
+#endif
+        if (n < 32) {
+            auto valid = (std::uint32_t(1) << n) - 1;
+            quotes &= valid;
+            seps &= valid;
+            newlines &= valid;
+        }
+
+        auto quoted = prefix_xor(quotes) ^ (in_quote ? ~std::uint32_t(0) : 0);
+        in_quote = quoted >> 31;
+
+        return (seps | newlines) & ~quoted;
+    }
+
+    const char* first = nullptr;
+    const char* last = nullptr;
+    csv_options options;
+
+    // The block being scanned, and the offset of the next.
+    const char* block = nullptr;
+    std::ptrdiff_t offset = 0;
+
+    std::uint32_t mask = 0;
+    bool in_quote = false;
+};
+
+}
+
+/*
+The rows of CSV (or TSV, or ...) text in a contiguous range of chars, each a
+csv_row<N> of std::string_views into the range; nothing is copied. Rows end at
+"\n" or "\r\n" outside quotes, and a blank line is a row of no fields. A row of more
+than N fields throws std::length_error.
+ */
+template<std::size_t N, class Range>
+class csv_container : public std::ranges::view_interface<csv_container<N, Range>>
+{
+  public:
+    class iterator
+    {
+      public:
+        using value_type = csv_row<N>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::forward_iterator_tag;
+
+        iterator() = default;
+
+        iterator(const char* first, const char* last, csv_options options)
+          : scanner(first, last, options)
+          , next_row(first)
+          , last(last)
+          , quote(options.quote)
+        {
+            ++*this;
+        }
+
+        const csv_row<N>& operator*() const { return row; }
+
+        iterator& operator++()
+        {
+            if (next_row == last) {
+                done = true;
+                return *this;
+            }
+
+            row.clear();
+            row_start = next_row;
+
+            for (auto first = next_row;;) {
+                auto p = scanner.next();
+                bool row_end = p == last || *p == '\n';
+
+                // A blank line, "\n" or "\r\n", is a row of no fields.
+                bool blank = row_end && row.empty() &&
+                             (p == first || (p == first + 1 && *first == '\r'));
+                if (!blank) {
+                    push_field(first, p, row_end);
+                }
+                if (row_end) {
+                    next_row = p == last ? last : p + 1;
+                    break;
+                }
+                first = p + 1;
+            }
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const iterator& rhs) const
+        {
+            return done == rhs.done && (done || row_start == rhs.row_start);
+        }
+
+        bool operator==(std::default_sentinel_t) const { return done; }
+
+      private:
+        void push_field(const char* first, const char* p, bool row_end)
+        {
+            std::string_view field(first, static_cast<std::size_t>(p - first));
+            if (row_end && field.ends_with('\r')) {
+                field.remove_suffix(1);
+            }
+            if (field.size() >= 2 && field.front() == quote && field.back() == quote) {
+                field = field.substr(1, field.size() - 2);
+            }
+            row.push_back(field);
+        }
+
+        detail::csv_scanner scanner;
+        csv_row<N> row;
+
+        const char* row_start = nullptr;
+        const char* next_row = nullptr;
+        const char* last = nullptr;
+        char quote = '"';
+        bool done = false;
+    };
+
+    view_t<Range> range;
+    csv_options options;
+
+    csv_container(Range&& range, csv_options options)
+      : range(to_view(std::forward<Range>(range)))
+      , options(options)
+    {}
+
+    auto begin()
+    {
+        auto first = reinterpret_cast<const char*>(std::ranges::data(range));
+        return iterator(first, first + std::ranges::size(range), options);
+    }
+
+    auto end() { return std::default_sentinel; }
+};
+
+// Pieces shorter than this many bytes have their quotes counted on one thread.
+inline constexpr std::size_t csv_partition_min_chunk = std::size_t(1) << 16;
+
+/*
+Cuts CSV text into n or fewer pieces of whole rows, to be parsed in parallel. The
+text is first cut roughly into n equal chunks, and each chunk's quotes counted, on a
+thread of its own if it's large enough; whether a rough cut falls within a quoted
+field is then the parity of the counts before it, and the cut is moved past the next
+newline that doesn't.
+ */
+template<detail::ByteRange Range>
+std::vector<std::string_view>
+csv_partition(Range&& range, std::size_t n, csv_options options = {})
+{
+    std::string_view text(reinterpret_cast<const char*>(std::ranges::data(range)),
+                          std::ranges::size(range));
+    std::vector<std::string_view> pieces;
+    n = std::max<std::size_t>(n, 1);
+
+    auto rough = [&](std::size_t i) { return text.size() * i / n; };
+
+    // Whether each chunk, [rough(c), rough(c + 1)), has an odd number of quotes.
+    std::vector<char> odd(n);
+    auto count = [&](std::size_t c) {
+        auto chunk = text.substr(rough(c), rough(c + 1) - rough(c));
+        odd[c] = std::ranges::count(chunk, options.quote) % 2 != 0;
+    };
+    if (n > 1 && text.size() / n >= csv_partition_min_chunk) {
+        std::vector<std::thread> pool;
+        for (std::size_t c = 1; c < n; ++c) {
+            pool.emplace_back(count, c);
+        }
+        count(0);
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    } else {
+        for (std::size_t c = 0; c < n; ++c) {
+            count(c);
+        }
+    }
+
+    std::size_t first = 0;
+    bool odd_before = false;
+
+    for (std::size_t i = 1; i <= n && first < text.size(); ++i) {
+        odd_before ^= odd[i - 1] != 0;
+
+        // A previous cut past this one ended a row, outside quotes.
+        auto cut = rough(i);
+        bool in_quote = odd_before;
+        if (cut < first) {
+            cut = first;
+            in_quote = false;
+        }
+
+        for (; cut < text.size(); ++cut) {
+            if (text[cut] == options.quote) {
+                in_quote = !in_quote;
+            } else if (text[cut] == '\n' && !in_quote) {
+                ++cut;
+                break;
+            }
+        }
+
+        pieces.push_back(text.substr(first, cut - first));
+        first = cut;
+    }
+    return pieces;
+}
+
+namespace detail {
+template<std::size_t N, ByteRange Range>
+constexpr auto
+csv(Range&& range, csv_options options)
+{
+    return csv_container<N, Range>(std::forward<Range>(range), options);
+}
+}
+
+template<std::size_t N = 32>
+constexpr auto
+csv(csv_options options = {})
+{
+    return [=]<class Range>(Range&& range) {
+        return detail::csv<N>(std::forward<Range>(range), options);
+    };
+}
+
+// The i-th field of each row, as a T parsed by csv_row::get.
+template<class T = std::string_view>
+constexpr auto
+column(std::size_t i)
+{
+    return views::transform(
+      [i]<std::size_t N>(const csv_row<N>& row) { return row.template get<T>(i); });
+}
+
+}
+}
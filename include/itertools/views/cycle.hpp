@@ -0,0 +1,247 @@
+#include "itertools/range_iterator.hpp"
+#include "itertools/views/selection.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#pragma once
+
+namespace itertools {
+namespace views {
+
+/*
+A range's elements, over and over: Python's itertools.cycle. A range that isn't
+sized and random access is first copied into a std::vector, as Python saves what it
+reads. Without a count of passes it never ends; with one, it's a sized range of that
+many passes.
+
+The iterator keeps its place in the pass, i, and the pass, and wraps i back to 0 by
+comparing it to the range's size, rather than by a % a step; only jumps of += divide.
+
+A bounded cycle fed to to<Container>() is written in bulk: a contiguous range of
+trivially copyable elements copied once into a contiguous container, then doubled by
+memcpy from the container itself until it's full; any other, a pass at a time, by the
+container's insert.
+ */
+template<class Range, bool Bounded>
+class cycle_container
+  : public std::ranges::view_interface<cycle_container<Range, Bounded>>
+{
+  public:
+    using range_t = detail::indexable_t<Range>;
+    using iter_t = std::ranges::iterator_t<range_t>;
+
+    class iterator
+    {
+      public:
+        using value_type = std::iter_value_t<iter_t>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::random_access_iterator_tag;
+
+        iterator() = default;
+
+        constexpr iterator(iter_t first, difference_type n, difference_type pass)
+          : first(std::move(first))
+          , n(n)
+          , pass(pass)
+        {}
+
+        constexpr iterator& operator++()
+        {
+            if (++i == n) {
+                i = 0;
+                ++pass;
+            }
+            return *this;
+        }
+
+        constexpr iterator& operator--()
+        {
+            if (i == 0) {
+                i = n;
+                --pass;
+            }
+            --i;
+            return *this;
+        }
+
+        constexpr iterator operator++(int)
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        constexpr iterator operator--(int)
+        {
+            auto tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        constexpr iterator& operator+=(difference_type k)
+        {
+            if (n > 0) {
+                auto at = pass * n + i + k;
+                pass = at / n;
+                i = at % n;
+                if (i < 0) {
+                    i += n;
+                    --pass;
+                }
+            }
+            return *this;
+        }
+
+        constexpr iterator& operator-=(difference_type k) { return *this += -k; }
+
+        constexpr iterator operator+(difference_type k) const
+        {
+            auto tmp = *this;
+            tmp += k;
+            return tmp;
+        }
+
+        constexpr iterator operator-(difference_type k) const
+        {
+            auto tmp = *this;
+            tmp -= k;
+            return tmp;
+        }
+
+        friend constexpr iterator operator+(difference_type k, const iterator& rhs)
+        {
+            return rhs + k;
+        }
+
+        constexpr difference_type operator-(const iterator& rhs) const
+        {
+            return (pass - rhs.pass) * n + (i - rhs.i);
+        }
+
+        constexpr bool operator==(const iterator& rhs) const
+        {
+            return pass == rhs.pass && i == rhs.i;
+        }
+
+        constexpr auto operator<=>(const iterator& rhs) const
+        {
+            if (auto c = pass <=> rhs.pass; c != 0) {
+                return c;
+            }
+            return i <=> rhs.i;
+        }
+
+        // An unbounded cycle ends only if there's nothing to cycle.
+        constexpr bool operator==(std::default_sentinel_t) const { return n == 0; }
+
+        constexpr decltype(auto) operator*() const { return first[i]; }
+
+        constexpr decltype(auto) operator[](difference_type k) const
+        {
+            return *(*this + k);
+        }
+
+      private:
+        iter_t first{};
+        difference_type n = 0;
+        difference_type pass = 0;
+        difference_type i = 0;
+    };
+
+    // For slice: jumps past the end of a pass are fine, as an empty cycle's += is a
+    // no-op.
+    static constexpr bool is_unbounded = !Bounded;
+
+    range_t range;
+    std::size_t passes = 0;
+
+    cycle_container(Range&& range, std::size_t passes = 0)
+      : range(detail::indexable(std::forward<Range>(range)))
+      , passes(std::ranges::empty(this->range) ? 0 : passes)
+    {}
+
+    auto begin() { return iterator(std::ranges::begin(range), length(), 0); }
+
+    auto end()
+    {
+        if constexpr (Bounded) {
+            return iterator(std::ranges::begin(range),
+                            length(),
+                            static_cast<std::ptrdiff_t>(passes));
+        } else {
+            return std::default_sentinel;
+        }
+    }
+
+    std::size_t size() requires Bounded { return passes * std::ranges::size(range); }
+
+    // For to<Container>(): every pass, at once.
+    template<class Container>
+    void assign_to(Container& container)
+      requires Bounded && requires {
+          container.insert(
+            container.end(), std::ranges::begin(range), std::ranges::end(range));
+      }
+    {
+        using T = std::ranges::range_value_t<range_t>;
+        constexpr bool is_memcpy =
+          std::ranges::contiguous_range<range_t> && std::is_trivially_copyable_v<T> &&
+          requires {
+              container.resize(0);
+              { container.data() } -> std::same_as<T*>;
+          };
+
+        auto n = std::ranges::size(range);
+        if constexpr (is_memcpy) {
+            auto total = size();
+            container.resize(total);
+            if (total == 0) {
+                return;
+            }
+            auto out = container.data();
+            std::memcpy(out, std::ranges::data(range), n * sizeof(T));
+            for (auto filled = n; filled < total; filled *= 2) {
+                std::memcpy(
+                  out + filled, out, std::min(filled, total - filled) * sizeof(T));
+            }
+        } else {
+            if constexpr (requires { container.reserve(size()); }) {
+                container.reserve(size());
+            }
+            for (std::size_t pass = 0; pass < passes; ++pass) {
+                container.insert(
+                  container.end(), std::ranges::begin(range), std::ranges::end(range));
+            }
+        }
+    }
+
+  private:
+    std::ptrdiff_t length()
+    {
+        return static_cast<std::ptrdiff_t>(std::ranges::size(range));
+    }
+};
+
+// A range's elements, without end.
+template<class Range>
+constexpr auto
+cycle(Range&& range)
+{
+    return cycle_container<Range, false>(std::forward<Range>(range));
+}
+
+// A range's elements, "passes" times over.
+template<class Range>
+constexpr auto
+cycle(Range&& range, std::size_t passes)
+{
+    return cycle_container<Range, true>(std::forward<Range>(range), passes);
+}
+
+}
+}
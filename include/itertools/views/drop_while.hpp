@@ -6,26 +6,43 @@ namespace itertools {
 namespace views {
 
 template<class Pred, class Range>
-class drop_while_container : cached_container<Range>
+class drop_while_container
+  : public cached_container<Range>
+  , public std::ranges::view_interface<drop_while_container<Pred, Range>>
 {
   public:
-    Pred pred;
+    movable_box<Pred> pred;
 
     drop_while_container(Pred&& pred, Range&& range)
       : cached_container<Range>(std::forward<Range>(range))
       , pred(std::forward<Pred>(pred))
     {}
 
-    void init_begin() override { this->end_ = std::end(this->range); }
+    void init_begin() override { this->end_ = std::ranges::end(this->range); }
 
     void init_end() override
     {
-        this->begin_ = itertools::find_if(std::begin(this->range), *this->end_, pred);
+        this->begin_ =
+          itertools::find_if(std::ranges::begin(this->range), *this->end_, *pred);
     }
 
     auto begin() { return range_iterator(this->cache_begin()); }
 
-    auto end() { return range_iterator(this->cache_end()); }
+    auto end()
+    {
+        if constexpr (std::ranges::common_range<view_t<Range>>) {
+            return range_iterator(this->cache_end());
+        } else {
+            return range_sentinel(this->cache_end());
+        }
+    }
+
+    auto size() requires std::sized_sentinel_for<
+      typename cached_container<Range>::end_t,
+      typename cached_container<Range>::begin_t>
+    {
+        return static_cast<std::size_t>(this->cache_end() - this->cache_begin());
+    }
 };
 
 template<class Pred, class Range>
@@ -53,4 +70,4 @@ drop_while(Pred&& pred)
 }
 
 }
-}
\ No newline at end of file
+}
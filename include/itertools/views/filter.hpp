@@ -8,72 +8,104 @@ namespace itertools {
 namespace views {
 
 template<class Pred, class Range>
-class filter_container : public cached_container<Range>
+class filter_container
+  : public cached_container<Range>
+  , public std::ranges::view_interface<filter_container<Pred, Range>>
 {
   public:
     template<class Iter>
-    class iterator : public range_iterator<Iter>
+    class iterator : public range_iterator<Iter, iterator<Iter>>
     {
       public:
-        using iterator_type = std::remove_cvref_t<Iter>;
-        using value_type = iter_value_t<iterator_type>;
-        using reference = value_type&;
+        using iterator_concept =
+          std::conditional_t<std::bidirectional_iterator<Iter>,
+                             std::bidirectional_iterator_tag,
+                             iterator_concept_t<Iter>>;
 
-        filter_container* base;
+        filter_container* base = nullptr;
 
-        iterator(filter_container* base, Iter&& it)
-          : range_iterator<Iter>(std::forward<Iter>(it))
+        iterator() = default;
+
+        iterator(filter_container* base, Iter it)
+          : range_iterator<Iter, iterator<Iter>>(std::move(it))
           , base(base)
         {}
 
-        auto operator++() -> decltype(auto)
+        auto operator++() -> iterator&
         {
-            this->it = itertools::find_if(++this->it, *base->end_, base->pred);
+            this->it = itertools::find_if(++this->it, *base->end_, *base->pred);
             return *this;
         }
 
-        auto operator--() -> decltype(auto)
+        auto operator--() -> iterator&
         {
-            while (--this->it != *base->end_) {
-                if (std::invoke(base->pred, *this->it)) {
-                    break;
-                }
-            }
+            do {
+                --this->it;
+            } while (!std::invoke(*base->pred, *this->it));
             return *this;
         }
+
+        using range_iterator<Iter, iterator<Iter>>::operator++;
+        using range_iterator<Iter, iterator<Iter>>::operator--;
+
+        friend decltype(auto) iter_move(const iterator& i) noexcept(
+          noexcept(std::ranges::iter_move(i.it)))
+        {
+            return std::ranges::iter_move(i.it);
+        }
     };
 
-    template<class Iter>
-    iterator(filter_container*, Iter&&) -> iterator<Iter>;
+    using iterator_t = iterator<typename cached_container<Range>::begin_t>;
 
-    Pred pred;
+    movable_box<Pred> pred;
 
     filter_container(Pred&& pred, Range&& range)
       : cached_container<Range>(std::forward<Range>(range))
       , pred(std::forward<Pred>(pred))
     {}
 
-    void init_begin() override { this->end_ = this->range.end(); }
-
-    void init_end() override
+    void init_begin() override
     {
-        this->begin_ = itertools::find_if(this->range.begin(), *this->end_, pred);
+        this->begin_ = itertools::find_if(
+          std::ranges::begin(this->range), std::ranges::end(this->range), *pred);
     }
 
-    auto begin() { return iterator(this, this->cache_begin()); }
+    void init_end() override { this->end_ = std::ranges::end(this->range); }
 
-    auto end() { return iterator(this, this->cache_end()); }
+    auto begin() { return iterator_t(this, this->cache_begin()); }
+
+    auto end()
+    {
+        if constexpr (std::ranges::common_range<view_t<Range>>) {
+            return iterator_t(this, this->cache_end());
+        } else {
+            return range_sentinel(this->cache_end());
+        }
+    }
 };
 
 template<class Pred, class Range>
 filter_container(Pred&&, Range&&) -> filter_container<Pred, Range>;
 
 namespace detail {
+/*
+A filter over a filter is fused into one, over the inner filter's range, whose
+predicate is the conjunction of the two.
+ */
 template<class Pred, class Range>
-constexpr filter_container<Pred, Range>
+constexpr auto
 filter(Pred pred, Range&& range)
 {
-    return filter_container<Pred, Range>(std::move(pred), std::forward<Range>(range));
+    if constexpr (is_instance<std::remove_cvref_t<Range>, filter_container>::value) {
+        auto conjoined = [p = *range.pred, q = std::move(pred)]<class T>(
+                           T&& x) mutable -> bool {
+            return std::invoke(p, x) && std::invoke(q, x);
+        };
+        return filter(std::move(conjoined), std::forward<Range>(range).range);
+    } else {
+        return filter_container<Pred, Range>(std::move(pred),
+                                             std::forward<Range>(range));
+    }
 };
 }
 
@@ -87,4 +119,4 @@ filter(Pred&& pred)
 }
 
 }
-}
\ No newline at end of file
+}
@@ -1,162 +1,185 @@
-// #include "itertools/algorithm/begin_end.hpp"
-// #include "itertools/range_iterator.hpp"
-// #include "itertools/tupletools.hpp"
-
-// #pragma once
-
-// namespace itertools {
-// namespace views {
-
-// using namespace tupletools;
-
-// template<class Range,
-//          class OuterBegin = iter_begin_t<Range>,
-//          class OuterEnd = iter_end_t<Range>,
-//          class InnerBegin = decltype(std::declval<OuterBegin>()->begin()),
-//          class InnerEnd = decltype(std::declval<OuterEnd>()->end())>
-// using cached_flattened_container =
-//   cached_container<Range,
-//                    std::tuple<OuterBegin, InnerBegin, InnerEnd>,
-//                    std::tuple<OuterEnd, InnerEnd, InnerBegin>>;
-
-// auto
-// advance_nested_it(auto& outer_it, bool is_reversed = false)
-// {
-//     if (is_reversed) {
-//         --outer_it;
-//         auto tup = std::make_tuple(outer_it->end(), outer_it->begin());
-//         ++outer_it;
-//         return tup;
-//     } else {
-//         return std::make_tuple(outer_it->begin(), outer_it->end());
-//     }
-// }
-
-// template<class Range>
-// class flatten_container : cached_flattened_container<Range>
-// {
-//   public:
-//     template<class Iter>
-//     class iterator : public range_iterator<Iter>
-//     {
-//       private:
-//         auto& get_nested() { return (is_reversed ? *base->end_ : *base->begin_); }
-//         auto& outer() { return std::get<0>(get_nested()); }
-//         auto& end() { return std::get<2>(get_nested()); }
-
-//         bool is_complete() { return this->it == end(); }
-
-//         bool is_outer_complete()
-//         {
-//             return std::get<0>(*base->begin_) == std::get<0>(*base->end_);
-//         }
-
-//         void advance(auto&& advance_func)
-//         {
-//             if (this->is_complete() and !this->is_outer_complete()) {
-
-//                 advance_func(this);
-
-//                 if (!this->is_outer_complete()) {
-//                     inner_advance();
-//                 }
-//             }
-//         }
-
-//         void inner_advance()
-//         {
-//             std::tie(this->it, end()) = advance_nested_it(outer(), is_reversed);
-//         }
-
-//       public:
-//         using value_t = std::remove_cvref_t<Iter>;
-
-//         flatten_container* base;
-//         value_t cached_value;
-//         bool is_reversed;
-
-//         iterator(flatten_container* base, Iter&& it, bool is_reversed = false)
-//           : range_iterator<Iter>{ std::forward<Iter>(it) }
-//           , base(base)
-//           , cached_value(it)
-//           , is_reversed(is_reversed)
-//         {}
-
-//         template<class T>
-//         bool operator==(const iterator<T>& rhs) const
-//         {
-//             return this->it == rhs.it;
-//         }
-
-//         decltype(auto) operator++()
-//         {
-
-//             ++this->it;
-//             constexpr auto func = [](auto&& self) { ++(self->outer()); };
-
-//             advance(func);
-//             cached_value = this->it;
-
-//             return *this;
-//         }
-
-//         decltype(auto) operator--()
-//         {
-//             --this->it;
-//             constexpr auto func = [](auto&& self) { --(self->outer()); };
-
-//             cached_value = this->it;
-//             advance(func);
-
-//             return *this;
-//         }
-//         auto operator*() -> decltype(auto) { return *cached_value; }
-//         auto operator->() -> decltype(auto) { return this->it; }
-//     };
-
-//     template<class Iter>
-//     iterator(flatten_container*, Iter&&, bool = false) -> iterator<Iter>;
-
-//     flatten_container(Range&& range)
-//       : cached_flattened_container<Range>(std::forward<Range>(range))
-//     {}
-
-//     void init_begin() override
-//     {
-//         auto outer = this->range.begin();
-//         auto [inner_begin, inner_end] = advance_nested_it(outer);
-
-//         this->begin_ = std::make_tuple(outer, inner_begin, inner_end);
-//     }
-//     void init_end() override
-//     {
-//         auto outer = this->range.end();
-//         auto [inner_begin, inner_end] = advance_nested_it(outer, true);
-
-//         this->end_ = std::make_tuple(outer, inner_begin, inner_end);
-//     }
-
-//     auto begin() { return iterator(this, std::get<1>(this->cache_begin())); }
-
-//     auto end() { return iterator(this, std::get<1>(this->cache_end()), true); }
-// };
-
-// template<class Range>
-// flatten_container(Range&&) -> flatten_container<Range>;
-
-// template<NestedRange Range>
-// constexpr flatten_container<Range>
-// flatten(Range&& range)
-// {
-//     return flatten_container(std::forward<Range>(range));
-// }
-
-// template<class Range>
-// constexpr auto
-// flatten(Range&& range)
-// {
-//     return range;
-// }
-
-// }
-// }
\ No newline at end of file
+#include "itertools/algorithm/begin_end.hpp"
+#include "itertools/range_iterator.hpp"
+#include "itertools/tupletools.hpp"
+
+#pragma once
+
+namespace itertools {
+namespace views {
+
+namespace detail {
+
+template<class Outer, class Inner>
+using flatten_concept_t = std::conditional_t<
+  std::ranges::bidirectional_range<Outer> && std::ranges::common_range<Outer> &&
+    std::ranges::bidirectional_range<Inner> && std::ranges::common_range<Inner>,
+  std::bidirectional_iterator_tag,
+  std::conditional_t<std::ranges::forward_range<Outer> &&
+                       std::ranges::forward_range<Inner>,
+                     std::forward_iterator_tag,
+                     std::input_iterator_tag>>;
+
+}
+
+/*
+Flattens a range of ranges by one level. An iterator is a pair of the outer
+iterator, "outer", and an iterator into the range it refers to, "it"; empty inner
+ranges are skipped over in both directions.
+
+The inner ranges are iterated in place, so the outer range must yield them by
+reference.
+
+Sinks take it a segment, an inner range, at a time, rather than checking for each
+element whether it's the last of one: to<Container>() inserts whole segments, by the
+container's range insert (a memcpy, for contiguous, trivially copyable elements),
+having reserved their total; views::scan runs its tight loop over each. A sink of its
+own can do the same, over segments().
+ */
+template<class Range>
+class flatten_container : public std::ranges::view_interface<flatten_container<Range>>
+{
+  public:
+    using OuterIter = view_iterator_t<Range>;
+    using Inner = std::ranges::range_reference_t<view_t<Range>>;
+    using InnerIter = std::ranges::iterator_t<Inner>;
+
+    static_assert(std::is_lvalue_reference_v<Inner>,
+                  "flatten requires a range whose elements are lvalue ranges");
+
+    class iterator : public range_iterator<InnerIter, iterator>
+    {
+        using base_t = range_iterator<InnerIter, iterator>;
+
+        constexpr void satisfy()
+        {
+            for (; outer != std::ranges::end(base->range); ++outer) {
+                auto&& inner = *outer;
+                this->it = std::ranges::begin(inner);
+                if (this->it != std::ranges::end(inner)) {
+                    return;
+                }
+            }
+            this->it = InnerIter{};
+        }
+
+      public:
+        using iterator_concept =
+          detail::flatten_concept_t<view_t<Range>, std::remove_cvref_t<Inner>>;
+
+        using base_t::operator++;
+        using base_t::operator--;
+
+        flatten_container* base = nullptr;
+        OuterIter outer{};
+
+        iterator() = default;
+
+        constexpr iterator(flatten_container* base, OuterIter outer)
+          : base(base)
+          , outer(std::move(outer))
+        {
+            satisfy();
+        }
+
+        constexpr bool operator==(const iterator& rhs) const
+        {
+            return outer == rhs.outer && this->it == rhs.it;
+        }
+
+        constexpr bool operator==(std::default_sentinel_t) const
+        {
+            return outer == std::ranges::end(base->range);
+        }
+
+        constexpr iterator& operator++()
+        {
+            if (++this->it == std::ranges::end(*outer)) {
+                ++outer;
+                satisfy();
+            }
+            return *this;
+        }
+
+        constexpr iterator& operator--()
+        {
+            if (outer == std::ranges::end(base->range)) {
+                this->it = std::ranges::end(*--outer);
+            }
+            while (this->it == std::ranges::begin(*outer)) {
+                this->it = std::ranges::end(*--outer);
+            }
+            --this->it;
+            return *this;
+        }
+
+        friend constexpr decltype(auto) iter_move(const iterator& i) noexcept(
+          noexcept(std::ranges::iter_move(i.it)))
+        {
+            return std::ranges::iter_move(i.it);
+        }
+    };
+
+    view_t<Range> range;
+
+    constexpr flatten_container(Range&& range)
+      : range(to_view(std::forward<Range>(range)))
+    {}
+
+    auto begin() { return iterator(this, std::ranges::begin(range)); }
+
+    auto end()
+    {
+        if constexpr (std::ranges::common_range<view_t<Range>>) {
+            return iterator(this, std::ranges::end(range));
+        } else {
+            return std::default_sentinel;
+        }
+    }
+
+    // The inner ranges, for sinks that take a segment at a time.
+    auto& segments() { return range; }
+
+    // For to<Container>(): a segment at a time.
+    template<class Container>
+    void assign_to(Container& container) requires requires(Inner inner)
+    {
+        container.insert(
+          container.end(), std::ranges::begin(inner), std::ranges::end(inner));
+    }
+    {
+        if constexpr (std::ranges::forward_range<view_t<Range>> &&
+                      std::ranges::sized_range<std::remove_cvref_t<Inner>> &&
+                      requires { container.reserve(container.size()); }) {
+            auto total = container.size();
+            for (auto&& inner : range) {
+                total += static_cast<std::size_t>(std::ranges::size(inner));
+            }
+            container.reserve(total);
+        }
+        for (auto&& inner : range) {
+            container.insert(
+              container.end(), std::ranges::begin(inner), std::ranges::end(inner));
+        }
+    }
+};
+
+template<class Range>
+flatten_container(Range&&) -> flatten_container<Range>;
+
+template<NestedRange Range>
+constexpr flatten_container<Range>
+flatten(Range&& range)
+{
+    return flatten_container<Range>(std::forward<Range>(range));
+}
+
+// Python's name for flatten: itertools.chain.from_iterable.
+template<NestedRange Range>
+constexpr flatten_container<Range>
+chain_from_iterable(Range&& range)
+{
+    return flatten_container<Range>(std::forward<Range>(range));
+}
+
+}
+}
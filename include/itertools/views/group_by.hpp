@@ -0,0 +1,260 @@
+#include "itertools/range_iterator.hpp"
+
+#include <bit>
+#include <functional>
+#include <optional>
+#include <utility>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#pragma once
+
+namespace itertools {
+namespace views {
+namespace detail {
+
+// Keys that group_by compares a vector at a time, when they're a range's own values.
+template<class T>
+concept SimdKey = (std::integral<T> || std::same_as<T, float> ||
+                   std::same_as<T, double>)&&sizeof(T) <= 8;
+
+#if defined(__AVX2__) || defined(__SSE2__)
+
+#ifdef __AVX2__
+inline constexpr std::ptrdiff_t group_vector_bytes = 32;
+#else
+inline constexpr std::ptrdiff_t group_vector_bytes = 16;
+#endif
+
+/*
+The index of the first of the values at p, a vector's worth, that isn't equal to
+"value", or -1. Integers are compared bytewise; floats as floats, so that -0.0 is
+0.0 and NaN is nothing, as with ==.
+ */
+template<SimdKey T>
+inline int
+first_difference(const T* p, T value)
+{
+    unsigned same;
+#ifdef __AVX2__
+    if constexpr (std::same_as<T, float>) {
+        auto eq = _mm256_cmp_ps(_mm256_loadu_ps(p), _mm256_set1_ps(value), _CMP_EQ_OQ);
+        same = static_cast<unsigned>(_mm256_movemask_ps(eq)) | ~0xFFu;
+    } else if constexpr (std::same_as<T, double>) {
+        auto eq = _mm256_cmp_pd(_mm256_loadu_pd(p), _mm256_set1_pd(value), _CMP_EQ_OQ);
+        same = static_cast<unsigned>(_mm256_movemask_pd(eq)) | ~0xFu;
+    } else {
+        __m256i needle;
+        if constexpr (sizeof(T) == 1) {
+            needle = _mm256_set1_epi8(static_cast<char>(value));
+        } else if constexpr (sizeof(T) == 2) {
+            needle = _mm256_set1_epi16(static_cast<short>(value));
+        } else if constexpr (sizeof(T) == 4) {
+            needle = _mm256_set1_epi32(static_cast<int>(value));
+        } else {
+            needle = _mm256_set1_epi64x(static_cast<long long>(value));
+        }
+        auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        auto eq = _mm256_cmpeq_epi8(block, needle);
+        same = static_cast<unsigned>(_mm256_movemask_epi8(eq));
+    }
+#else
+    if constexpr (std::same_as<T, float>) {
+        auto eq = _mm_cmpeq_ps(_mm_loadu_ps(p), _mm_set1_ps(value));
+        same = static_cast<unsigned>(_mm_movemask_ps(eq)) | ~0xFu;
+    } else if constexpr (std::same_as<T, double>) {
+        auto eq = _mm_cmpeq_pd(_mm_loadu_pd(p), _mm_set1_pd(value));
+        same = static_cast<unsigned>(_mm_movemask_pd(eq)) | ~0x3u;
+    } else {
+        __m128i needle;
+        if constexpr (sizeof(T) == 1) {
+            needle = _mm_set1_epi8(static_cast<char>(value));
+        } else if constexpr (sizeof(T) == 2) {
+            needle = _mm_set1_epi16(static_cast<short>(value));
+        } else if constexpr (sizeof(T) == 4) {
+            needle = _mm_set1_epi32(static_cast<int>(value));
+        } else {
+            needle = _mm_set1_epi64x(static_cast<long long>(value));
+        }
+        auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        auto eq = _mm_cmpeq_epi8(block, needle);
+        same = static_cast<unsigned>(_mm_movemask_epi8(eq)) | ~0xFFFFu;
+    }
+#endif
+    if (same == ~0u) {
+        return -1;
+    }
+    // Byte masks count bytes; lane masks, lanes.
+    auto i = std::countr_one(same);
+    return std::integral<T> ? i / static_cast<int>(sizeof(T)) : i;
+}
+
+#endif
+
+// The first of [first, last) not equal to "value", or last.
+template<SimdKey T>
+inline const T*
+find_not_equal(const T* first, const T* last, T value)
+{
+#if defined(__AVX2__) || defined(__SSE2__)
+    constexpr auto lanes = group_vector_bytes / static_cast<std::ptrdiff_t>(sizeof(T));
+    for (; last - first >= lanes; first += lanes) {
+        if (auto i = first_difference(first, value); i >= 0) {
+            return first + i;
+        }
+    }
+#endif
+    while (first != last && *first == value) {
+        ++first;
+    }
+    return first;
+}
+
+}
+
+/*
+The runs of consecutive elements with equal keys, as (key, subrange) pairs, like
+Python's itertools.groupby: sorted by key, a range's groups. The subranges are of
+the range itself, so nothing is copied, and the key function is called once an
+element: the key that ends a run is kept as the next run's.
+
+With no key function, elements are grouped by their own value; a contiguous range
+of integers or floats then finds the end of each run with SIMD comparisons.
+ */
+template<class Func, class Range>
+class group_by_container
+  : public std::ranges::view_interface<group_by_container<Func, Range>>
+{
+    static_assert(std::ranges::forward_range<view_t<Range>>,
+                  "group_by ranges must be forward ranges");
+
+    using iter_t = view_iterator_t<Range>;
+
+    static constexpr bool is_simd =
+      std::same_as<Func, std::identity> &&
+      std::ranges::contiguous_range<view_t<Range>> &&
+      std::ranges::sized_range<view_t<Range>> &&
+      detail::SimdKey<std::ranges::range_value_t<view_t<Range>>>;
+
+  public:
+    using key_type =
+      std::remove_cvref_t<std::invoke_result_t<Func&, std::iter_reference_t<iter_t>>>;
+    using group_type = std::ranges::subrange<iter_t>;
+
+    class iterator
+    {
+      public:
+        using value_type = std::pair<key_type, group_type>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::forward_iterator_tag;
+
+        iterator() = default;
+
+        iterator(group_by_container* base, iter_t first)
+          : base(base)
+          , first(first)
+          , last(first)
+        {
+            if (first != std::ranges::end(base->range)) {
+                key.emplace(std::invoke(*base->func, *first));
+                find_last();
+            }
+        }
+
+        value_type operator*() const { return { *key, group_type(first, last) }; }
+
+        iterator& operator++()
+        {
+            first = last;
+            key = std::move(next_key);
+            next_key.reset();
+            if (key) {
+                find_last();
+            }
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const iterator& rhs) const { return first == rhs.first; }
+
+        bool operator==(std::default_sentinel_t) const
+        {
+            return first == std::ranges::end(base->range);
+        }
+
+      private:
+        // The end of the run of "key"; the key that ends it is the next run's.
+        void find_last()
+        {
+            auto end = std::ranges::end(base->range);
+            if constexpr (is_simd) {
+                auto p = std::to_address(first);
+                auto q = detail::find_not_equal(p + 1, p + (end - first), *key);
+                last = first + (q - p);
+                if (last != end) {
+                    next_key.emplace(*last);
+                }
+            } else {
+                for (last = std::ranges::next(first); last != end; ++last) {
+                    decltype(auto) k = std::invoke(*base->func, *last);
+                    if (!(k == *key)) {
+                        next_key.emplace(std::forward<decltype(k)>(k));
+                        return;
+                    }
+                }
+            }
+        }
+
+        group_by_container* base = nullptr;
+        iter_t first{}, last{};
+        std::optional<key_type> key, next_key;
+    };
+
+    view_t<Range> range;
+    movable_box<Func> func;
+
+    group_by_container(Func&& func, Range&& range)
+      : range(to_view(std::forward<Range>(range)))
+      , func(std::forward<Func>(func))
+    {}
+
+    auto begin() { return iterator(this, std::ranges::begin(range)); }
+
+    auto end()
+    {
+        if constexpr (std::ranges::common_range<view_t<Range>>) {
+            return iterator(this, std::ranges::end(range));
+        } else {
+            return std::default_sentinel;
+        }
+    }
+};
+
+namespace detail {
+template<class Func, class Range>
+constexpr auto
+group_by(Func func, Range&& range)
+{
+    return group_by_container<Func, Range>(std::move(func), std::forward<Range>(range));
+}
+}
+
+template<class Func = std::identity>
+constexpr auto
+group_by(Func&& func = {})
+{
+    return [func = std::forward<Func>(func)]<class Range>(Range&& range) {
+        return detail::group_by(func, std::forward<Range>(range));
+    };
+}
+
+}
+}
@@ -1,80 +1,150 @@
-#include <itertools/range_iterator.hpp>
+#include "itertools/range_iterator.hpp"
 
 #pragma once
 
-namespace itertools { namespace views {
+namespace itertools {
+namespace views {
 
-template<class Func, class Range>
-class intersperse_iterator : public range_iterator<Range>
+/*
+A range's elements with "value" between each two: 1, 0, 2, 0, 3 for [1, 2, 3]
+interspersed with 0. An iterator is at an element of the range, or at the value
+just before it ("at_value").
+ */
+template<class T, class Range>
+class intersperse_container
+  : public std::ranges::view_interface<intersperse_container<T, Range>>
 {
-public:
-    intersperse_iterator(Func func, Range&& range) noexcept
-      : range_iterator<Range>(std::forward<Range>(range))
-      , func{func}
-      , pos{0}
-    {}
-
-    bool do_intersperse()
+  public:
+    template<class Iter>
+    class iterator : public range_iterator<Iter, iterator<Iter>>
     {
-        return pos % 2 == 1;
-    }
+        using base_t = range_iterator<Iter, iterator<Iter>>;
 
-    auto operator++() -> decltype(auto)
-    {
-        if (!do_intersperse()) {
-            ++this->begin_it;
+      public:
+        // Stepping back from the end needs to know where the end is.
+        using iterator_concept =
+          std::conditional_t<std::bidirectional_iterator<Iter> &&
+                               std::ranges::common_range<view_t<Range>>,
+                             std::bidirectional_iterator_tag,
+                             std::conditional_t<std::forward_iterator<Iter>,
+                                                std::forward_iterator_tag,
+                                                iterator_concept_t<Iter>>>;
+
+        using reference =
+          std::common_reference_t<const T&, std::iter_reference_t<Iter>>;
+        using value_type = std::remove_cvref_t<reference>;
+
+        using difference_type = typename base_t::difference_type;
+
+        using base_t::operator++;
+        using base_t::operator--;
+
+        intersperse_container* base = nullptr;
+        bool at_value = false;
+
+        iterator() = default;
+
+        iterator(intersperse_container* base, Iter it, bool at_value = false)
+          : base_t(std::move(it))
+          , base(base)
+          , at_value(at_value)
+        {}
+
+        iterator& operator++()
+        {
+            if (at_value) {
+                at_value = false;
+            } else {
+                ++this->it;
+                at_value = this->it != std::ranges::end(base->range);
+            }
+            return *this;
         }
-        pos += 1;
-    }
 
-    auto operator--() -> decltype(auto)
-    {
-        if (!do_intersperse()) {
-            ++this->begin_it;
+        iterator& operator--()
+        {
+            if (at_value || this->it == std::ranges::end(base->range)) {
+                --this->it;
+                at_value = false;
+            } else {
+                at_value = true;
+            }
+            return *this;
         }
-        pos -= 1;
-    }
 
-    auto operator*()
+        reference operator*() const
+        {
+            if (at_value) {
+                return base->value;
+            }
+            return *this->it;
+        }
+
+        bool operator==(const iterator& rhs) const
+        {
+            return this->it == rhs.it && at_value == rhs.at_value;
+        }
+
+        // The i-th element is 2i along, its preceding value 2i - 1, and the end 2n - 1.
+        difference_type operator-(const iterator& rhs) const
+          requires std::sized_sentinel_for<Iter, Iter>
+        {
+            return 2 * (this->it - rhs.it) - offset() + rhs.offset();
+        }
+
+      private:
+        difference_type offset() const
+        {
+            return at_value || this->it == std::ranges::end(base->range);
+        }
+    };
+
+    using iterator_t = iterator<view_iterator_t<Range>>;
+
+    view_t<Range> range;
+    T value;
+
+    intersperse_container(Range&& range, T value)
+      : range(to_view(std::forward<Range>(range)))
+      , value(std::move(value))
+    {}
+
+    auto begin() { return iterator_t(this, std::ranges::begin(range)); }
+
+    auto end()
     {
-        if (do_intersperse()) {
-            return func();
+        if constexpr (std::ranges::common_range<view_t<Range>>) {
+            return iterator_t(this, std::ranges::end(range));
         } else {
-            return *this->begin_it;
+            return range_sentinel(std::ranges::end(range));
         }
     }
 
-private:
-    size_t pos;
-    Func func;
+    auto size() requires std::ranges::sized_range<view_t<Range>>
+    {
+        auto n = std::ranges::size(range);
+        return n == 0 ? n : 2 * n - 1;
+    }
 };
 
 namespace detail {
-template<class Func, class Range>
-constexpr decltype(auto)
-intersperse(Func func, Range&& range)
+template<class T, class Range>
+constexpr auto
+intersperse(Range&& range, T value)
 {
-    auto it =
-        intersperse_iterator<Func, Range>(std::move(func), std::forward<Range>(range));
-    return range_container(std::move(it));
+    return intersperse_container<T, Range>(std::forward<Range>(range),
+                                           std::move(value));
 };
 }
 
-template<tupletools::invocable Func>
-constexpr decltype(auto)
-intersperse(Func&& func)
-{
-    return [func = std::forward<Func>(func)]<class Range>(Range&& range) {
-        return detail::intersperse(func, std::forward<Range>(range));
-    };
-}
-
 template<class T>
-constexpr decltype(auto)
+constexpr auto
 intersperse(T value)
 {
-    auto func = [=]() -> T { return value; };
-    return intersperse(std::move(func));
+    return [value = std::move(value)]<class Range>(Range&& range) {
+        return detail::intersperse(std::forward<Range>(range), value);
+    };
 }
 
-}}
\ No newline at end of file
+}
+}
@@ -1,4 +1,5 @@
 #include "itertools/range_iterator.hpp"
+#include <cmath>
 #include <iostream>
 
 #pragma once
@@ -7,33 +8,98 @@ namespace itertools {
 namespace views {
 
 template<typename T = int>
-class iota
+class iota : public std::ranges::view_interface<iota<T>>
 {
   public:
+    /*
+    Random access iterator over the arithmetic sequence start, start + stride, ...
+    The iterator carries its own position, "n", so independent copies may be
+    advanced independently.
+     */
     class iterator
     {
       public:
-        explicit iterator(iota* base)
-          : base(base)
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::random_access_iterator_tag;
+
+        iterator() = default;
+
+        constexpr iterator(T start, T stride, difference_type n)
+          : start(start)
+          , stride(stride)
+          , n(n)
         {}
 
-        auto operator++()
+        constexpr iterator& operator++()
         {
-            base->current += base->stride;
+            ++n;
             return *this;
         }
 
-        auto operator--()
+        constexpr iterator& operator--()
         {
-            base->current -= base->stride;
+            --n;
             return *this;
         }
 
-        bool operator==(const iterator&) const { return base->current == base->stop; }
+        constexpr iterator operator++(int)
+        {
+            auto tmp = *this;
+            ++n;
+            return tmp;
+        }
+
+        constexpr iterator operator--(int)
+        {
+            auto tmp = *this;
+            --n;
+            return tmp;
+        }
 
-        const T operator*() { return base->current; }
+        constexpr iterator& operator+=(difference_type i)
+        {
+            n += i;
+            return *this;
+        }
 
-        iota* base;
+        constexpr iterator& operator-=(difference_type i)
+        {
+            n -= i;
+            return *this;
+        }
+
+        constexpr iterator operator+(difference_type i) const
+        {
+            return iterator(start, stride, n + i);
+        }
+
+        constexpr iterator operator-(difference_type i) const
+        {
+            return iterator(start, stride, n - i);
+        }
+
+        friend constexpr iterator operator+(difference_type i, const iterator& rhs)
+        {
+            return rhs + i;
+        }
+
+        constexpr difference_type operator-(const iterator& rhs) const
+        {
+            return n - rhs.n;
+        }
+
+        constexpr bool operator==(const iterator& rhs) const { return n == rhs.n; }
+
+        constexpr auto operator<=>(const iterator& rhs) const { return n <=> rhs.n; }
+
+        constexpr T operator*() const { return start + static_cast<T>(n) * stride; }
+
+        constexpr T operator[](difference_type i) const { return *(*this + i); }
+
+        T start{};
+        T stride{};
+        difference_type n = 0;
     };
 
     constexpr explicit iota(T stop)
@@ -41,10 +107,9 @@ class iota
       , stop(stop)
     {
         if (start > stop) {
-            std::swap(start, stop);
+            std::swap(this->start, this->stop);
         }
-        stride = start > stop ? -1 : 1;
-        current = start;
+        stride = 1;
     }
 
     constexpr iota(T start, T stop)
@@ -52,26 +117,50 @@ class iota
       , stop(stop)
     {
         stride = start > stop ? -1 : 1;
-        current = start;
     }
 
     constexpr iota(T start, T stop, T stride)
       : start(start)
       , stop(stop)
       , stride(stride)
-      , current(start)
     {}
 
-    int size() const { return size_; }
+    /*
+    The number of steps it takes to reach, or pass, stop; a stride pointing away
+    from stop yields an empty sequence.
+     */
+    constexpr std::size_t size() const
+    {
+        auto distance = [](T a, T b, T step) -> std::size_t {
+            if (b <= a) {
+                return 0;
+            }
+            if constexpr (std::is_floating_point_v<T>) {
+                return static_cast<std::size_t>(std::ceil((b - a) / step));
+            } else {
+                return static_cast<std::size_t>((b - a + step - 1) / step);
+            }
+        };
+
+        if (start <= stop) {
+            return (stride > 0) ? distance(start, stop, stride) : 0;
+        } else if constexpr (std::is_signed_v<T> || std::is_floating_point_v<T>) {
+            return (stride < 0) ? distance(stop, start, -stride) : 0;
+        } else {
+            // an unsigned stride that wraps around is a negative step.
+            return distance(stop, start, T(0) - stride);
+        }
+    }
 
-    auto begin() { return iterator(this); }
+    constexpr auto begin() const { return iterator(start, stride, 0); }
 
-    auto end() { return iterator(this); }
+    constexpr auto end() const
+    {
+        return iterator(start, stride, static_cast<std::ptrdiff_t>(size()));
+    }
 
     T start, stop, stride;
-    T current;
-    size_t size_ = 0;
 };
 
 }
-}
\ No newline at end of file
+}
@@ -1,15 +1,69 @@
-#include "intersperse.hpp"
-#include "transform.hpp"
+#include "fmt/format.h"
+
+#include "itertools/range_iterator.hpp"
+#include "itertools/views/split.hpp"
+
+#include <iterator>
+#include <string>
+#include <string_view>
 
 #pragma once
 
-namespace itertools { namespace views {
+namespace itertools {
+namespace views {
+namespace detail {
+
+template<class Range>
+std::string
+join(Range&& range, std::string_view delim)
+{
+    using reference = std::ranges::range_reference_t<Range>;
+
+    std::string ret;
+
+    // Sized from the elements themselves when they're strings and can be walked
+    // twice; otherwise guessed, a few characters apiece, from their count.
+    if constexpr (ByteRange<reference> && std::ranges::forward_range<Range>) {
+        std::size_t size = 0, n = 0;
+        for (auto&& x : range) {
+            size += std::ranges::size(x);
+            ++n;
+        }
+        ret.reserve(size + (n > 0 ? (n - 1) * delim.size() : 0));
+    } else if constexpr (std::ranges::sized_range<Range>) {
+        ret.reserve(std::ranges::size(range) * (delim.size() + 8));
+    }
+
+    bool first = true;
+    for (auto&& x : range) {
+        if (!first) {
+            ret += delim;
+        }
+        first = false;
+
+        if constexpr (ByteRange<reference>) {
+            auto data = reinterpret_cast<const char*>(std::ranges::data(x));
+            ret.append(data, std::ranges::size(x));
+        } else {
+            fmt::format_to(std::back_inserter(ret), "{}", x);
+        }
+    }
+    return ret;
+}
+
+}
 
-constexpr auto join = [](std::string delim) {
+/*
+Joins a range's elements into a string, "delim" between each two: strings as they
+are, and anything else formatted by fmt, straight into the one string.
+ */
+inline auto
+join(std::string_view delim)
+{
     return [=]<class Range>(Range&& range) {
-        auto t_string = [](auto&& x) { return fmt::format("{}", x); };
-        return range | views::transform(t_string) | views::intersperse(delim);
+        return detail::join(std::forward<Range>(range), delim);
     };
-};
+}
 
-}}
+}
+}
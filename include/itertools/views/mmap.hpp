@@ -0,0 +1,159 @@
+#include "itertools/range_iterator.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#pragma once
+
+namespace itertools {
+namespace views {
+
+// How a mapping is expected to be read; passed on to the kernel through madvise.
+enum class access
+{
+    // Read ahead aggressively, and drop pages once they've been passed.
+    sequential,
+    // Read no further than asked.
+    random
+};
+
+namespace detail {
+
+/*
+A read-only mapping of a whole file, unmapped on destruction. An empty file has
+no mapping, and a null data().
+ */
+class mapped_file
+{
+  public:
+    mapped_file(const std::filesystem::path& path, access how)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), path.string());
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) < 0) {
+            auto err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), path.string());
+        }
+
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ > 0) {
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                auto err = errno;
+                ::close(fd);
+                throw std::system_error(err, std::generic_category(), path.string());
+            }
+            data_ = static_cast<const std::byte*>(p);
+
+            // Advice is only a hint; a kernel that ignores it changes nothing.
+            if (how == access::sequential) {
+                ::madvise(p, size_, MADV_SEQUENTIAL);
+                ::madvise(p, size_, MADV_WILLNEED);
+            } else {
+                ::madvise(p, size_, MADV_RANDOM);
+            }
+        }
+        // The mapping outlives the descriptor.
+        ::close(fd);
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file()
+    {
+        if (data_) {
+            ::munmap(const_cast<std::byte*>(data_), size_);
+        }
+    }
+
+    const std::byte* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+  private:
+    const std::byte* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+}
+
+/*
+A file, mapped read-only, seen as a contiguous range of T: bytes, or fixed-size
+trivially copyable records. Trailing bytes too few to make up a whole record are
+not part of the range.
+
+Copies share the one mapping, which is released along with the last of them.
+ */
+template<class T>
+class mmap_container : public std::ranges::view_interface<mmap_container<T>>
+{
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "mmap'd records must be trivially copyable");
+
+  public:
+    mmap_container() = default;
+
+    mmap_container(const std::filesystem::path& path, access how = access::sequential)
+      : mmap_container(std::make_shared<const detail::mapped_file>(path, how))
+    {}
+
+    // The whole of an existing mapping.
+    explicit mmap_container(std::shared_ptr<const detail::mapped_file> file)
+      : mmap_container(file, 0, file->size() / sizeof(T))
+    {}
+
+    /*
+    "n" T's, "offset" bytes into an existing mapping. Pages are aligned far beyond
+    any T's alignment, so the cast is sound as long as "offset" is aligned for T.
+     */
+    mmap_container(std::shared_ptr<const detail::mapped_file> file,
+                   std::size_t offset,
+                   std::size_t n)
+      : file(std::move(file))
+      , first(reinterpret_cast<const T*>(this->file->data() + offset))
+      , n(n)
+    {}
+
+    const T* begin() const { return first; }
+
+    const T* end() const { return first + n; }
+
+    std::size_t size() const { return n; }
+
+    const T* data() const { return first; }
+
+  private:
+    std::shared_ptr<const detail::mapped_file> file;
+    const T* first = nullptr;
+    std::size_t n = 0;
+};
+
+inline auto
+mmap_bytes(const std::filesystem::path& path, access how = access::sequential)
+{
+    return mmap_container<std::byte>(path, how);
+}
+
+template<class T>
+auto
+mmap_records(const std::filesystem::path& path, access how = access::sequential)
+{
+    return mmap_container<T>(path, how);
+}
+
+}
+}
@@ -0,0 +1,210 @@
+#include "itertools/range_iterator.hpp"
+#include "itertools/views/split.hpp"
+#include "itertools/views/transform.hpp"
+
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#pragma once
+
+namespace itertools {
+namespace views {
+
+/*
+A parsed T, or the std::errc saying why there isn't one, in the manner of C++23's
+std::expected: std::errc::invalid_argument for anything that isn't wholly a T,
+std::errc::result_out_of_range for one that doesn't fit. Only value() throws.
+ */
+template<class T>
+class parse_result
+{
+  public:
+    constexpr parse_result(T value)
+      : value_(value)
+    {}
+
+    constexpr parse_result(std::errc error)
+      : error_(error)
+    {}
+
+    constexpr bool has_value() const { return error_ == std::errc{}; }
+    constexpr explicit operator bool() const { return has_value(); }
+
+    constexpr const T& operator*() const { return value_; }
+
+    constexpr std::errc error() const { return error_; }
+
+    constexpr T value() const
+    {
+        if (!has_value()) {
+            throw std::system_error(std::make_error_code(error_));
+        }
+        return value_;
+    }
+
+    constexpr T value_or(T default_value) const
+    {
+        return has_value() ? value_ : default_value;
+    }
+
+    constexpr bool operator==(const parse_result&) const = default;
+
+  private:
+    T value_{};
+    std::errc error_{};
+};
+
+namespace detail {
+
+/*
+Whether the 8 bytes of "chunk" (loaded little-endian) are all ASCII digits, and
+their value if so, in a handful of multiplies rather than 8; see Lemire,
+"Fast float parsing in practice".
+ */
+constexpr bool
+is_8_digits(std::uint64_t chunk)
+{
+    return ((chunk & 0xF0F0F0F0F0F0F0F0) |
+            (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+           0x3333333333333333;
+}
+
+constexpr std::uint32_t
+parse_8_digits(std::uint64_t chunk)
+{
+    constexpr std::uint64_t mask = 0x000000FF000000FF;
+    constexpr std::uint64_t mul1 = 100 + (1000000ULL << 32);
+    constexpr std::uint64_t mul2 = 1 + (10000ULL << 32);
+
+    chunk -= 0x3030303030303030;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+    return static_cast<std::uint32_t>(chunk);
+}
+
+inline std::uint64_t
+load_8(const char* p)
+{
+    std::uint64_t chunk;
+    std::memcpy(&chunk, p, sizeof chunk);
+    if constexpr (std::endian::native == std::endian::big) {
+        chunk = __builtin_bswap64(chunk);
+    }
+    return chunk;
+}
+
+/*
+The whole of "s" as a T. Integers short enough that they can't overflow are read 8
+digits at a time; anything else goes to std::from_chars.
+ */
+template<class T>
+parse_result<T>
+parse_number(std::string_view s)
+{
+    if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
+        using U = std::make_unsigned_t<T>;
+
+        bool negative = std::is_signed_v<T> && !s.empty() && s.front() == '-';
+        auto digits = s.substr(negative);
+
+        constexpr auto max_digits = std::size_t(std::numeric_limits<T>::digits10);
+
+        if (!digits.empty() && digits.size() <= max_digits) {
+            const char* p = digits.data();
+            const char* last = p + digits.size();
+            U value = 0;
+
+            for (; last - p >= 8; p += 8) {
+                auto chunk = load_8(p);
+                if (!is_8_digits(chunk)) {
+                    return std::errc::invalid_argument;
+                }
+                value = static_cast<U>(value * 100000000 + parse_8_digits(chunk));
+            }
+            for (; p != last; ++p) {
+                auto digit = static_cast<unsigned char>(*p - '0');
+                if (digit > 9) {
+                    return std::errc::invalid_argument;
+                }
+                value = static_cast<U>(value * 10 + digit);
+            }
+            return negative ? static_cast<T>(-static_cast<T>(value))
+                            : static_cast<T>(value);
+        }
+    }
+
+    T value{};
+    auto last = s.data() + s.size();
+    auto [p, ec] = std::from_chars(s.data(), last, value);
+    if (ec != std::errc{}) {
+        return ec;
+    } else if (p != last) {
+        return std::errc::invalid_argument;
+    }
+    return value;
+}
+
+}
+
+/*
+Parses each element, a std::string_view or anything convertible to one, into a
+parse_result<T>; nothing throws, and nothing is allocated.
+ */
+template<class T>
+constexpr auto
+parse()
+{
+    return views::transform(
+      [](std::string_view s) { return detail::parse_number<T>(s); });
+}
+
+struct parse_into_result
+{
+    // The values written, or, on an error, the index of the field that failed.
+    std::size_t count = 0;
+    std::errc error{};
+};
+
+/*
+Parses the "delim"-separated numbers of a contiguous range of bytes straight into
+"out", stopping at the first that fails. A trailing delimiter ends the last field,
+rather than beginning an empty one. If "out" is filled before the input's
+exhausted, the error is std::errc::no_buffer_space.
+ */
+template<class T, detail::ByteRange Range>
+parse_into_result
+parse_into(Range&& range, std::span<T> out, char delim = '\n')
+{
+    auto first = reinterpret_cast<const char*>(std::ranges::data(range));
+    auto last = first + std::ranges::size(range);
+
+    parse_into_result ret;
+    while (first != last) {
+        if (ret.count == out.size()) {
+            ret.error = std::errc::no_buffer_space;
+            break;
+        }
+
+        auto field_last = detail::find_byte(first, last, delim);
+        auto value = detail::parse_number<T>(
+          { first, static_cast<std::size_t>(field_last - first) });
+        if (!value) {
+            ret.error = value.error();
+            break;
+        }
+
+        out[ret.count++] = *value;
+        first = field_last == last ? last : field_last + 1;
+    }
+    return ret;
+}
+
+}
+}
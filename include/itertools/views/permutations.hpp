@@ -0,0 +1,223 @@
+#include "itertools/range_iterator.hpp"
+#include "itertools/views/selection.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#pragma once
+
+namespace itertools {
+namespace views {
+
+enum class permutation_order
+{
+    // Python's order: by position, as std::next_permutation would give.
+    lexicographic,
+    // Heap's algorithm: each permutation a single swap from the last.
+    minimal_change
+};
+
+/*
+The r-permutations of a range's elements, each a selection of r of them. An iterator
+holds one buffer of positions, permuted in place, so stepping allocates nothing;
+a selection is only good until its iterator's advanced.
+
+Lexicographic order takes the positions' next permutation, past the unused ones
+(which are kept sorted at the back), and can be entered anywhere: it + k unranks
+the permutation's index in the factorial number system, in O(n r), so that the
+permutations can be split among threads. Minimal change order is Heap's algorithm,
+of all n elements only, and is a single swap a step.
+ */
+template<permutation_order Order, class Range>
+class permutations_container
+  : public std::ranges::view_interface<permutations_container<Order, Range>>
+{
+    static constexpr bool is_lexicographic = Order == permutation_order::lexicographic;
+
+  public:
+    using range_t = detail::indexable_t<Range>;
+    using value_type = selection<std::ranges::iterator_t<range_t>>;
+
+    class iterator
+    {
+      public:
+        using value_type = permutations_container::value_type;
+        using difference_type = std::ptrdiff_t;
+        // A selection is of the iterator's own buffer.
+        using iterator_concept = std::forward_iterator_tag;
+
+        iterator() = default;
+
+        iterator(permutations_container* base, std::size_t rank)
+          : base(base)
+          , rank(rank)
+        {
+            if (rank < base->total) {
+                positions.resize(base->n);
+                if constexpr (is_lexicographic) {
+                    unrank();
+                } else {
+                    std::iota(positions.begin(), positions.end(), 0);
+                    counters.assign(base->n, 0);
+                }
+            }
+        }
+
+        value_type operator*() const
+        {
+            return { std::ranges::begin(base->range), { positions.data(), base->r } };
+        }
+
+        iterator& operator++()
+        {
+            if (++rank < base->total) {
+                step();
+            }
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        iterator& operator+=(difference_type k) requires is_lexicographic
+        {
+            rank += static_cast<std::size_t>(k);
+            if (rank < base->total) {
+                positions.resize(base->n);
+                unrank();
+            }
+            return *this;
+        }
+
+        iterator operator+(difference_type k) const requires is_lexicographic
+        {
+            auto tmp = *this;
+            tmp += k;
+            return tmp;
+        }
+
+        difference_type operator-(const iterator& rhs) const
+        {
+            return static_cast<difference_type>(rank - rhs.rank);
+        }
+
+        bool operator==(const iterator& rhs) const { return rank == rhs.rank; }
+
+      private:
+        void step()
+        {
+            if constexpr (is_lexicographic) {
+                auto r = static_cast<difference_type>(base->r);
+                std::reverse(positions.begin() + r, positions.end());
+                std::next_permutation(positions.begin(), positions.end());
+            } else {
+                auto n = base->n;
+                while (i < n) {
+                    if (counters[i] < i) {
+                        auto j = i % 2 == 0 ? 0 : counters[i];
+                        std::swap(positions[j], positions[i]);
+                        ++counters[i];
+                        i = 1;
+                        return;
+                    }
+                    counters[i] = 0;
+                    ++i;
+                }
+            }
+        }
+
+        // The rank-th permutation: each place's digit picks from what's left.
+        void unrank()
+        {
+            std::iota(positions.begin(), positions.end(), 0);
+            auto k = rank;
+            for (std::size_t j = 0; j < base->r; ++j) {
+                auto digit = static_cast<difference_type>(k / base->place_values[j]);
+                k %= base->place_values[j];
+
+                auto first = positions.begin() + static_cast<difference_type>(j);
+                std::rotate(first, first + digit, first + digit + 1);
+            }
+        }
+
+        permutations_container* base = nullptr;
+        std::size_t rank = 0;
+        std::vector<std::size_t> positions;
+
+        // Heap's algorithm's state.
+        std::vector<std::size_t> counters;
+        std::size_t i = 1;
+    };
+
+    range_t range;
+    std::size_t n = 0, r = 0;
+
+    permutations_container(Range&& range, std::optional<std::size_t> r)
+      : range(detail::indexable(std::forward<Range>(range)))
+      , n(std::ranges::size(this->range))
+      , r(r.value_or(n))
+    {
+        if (!is_lexicographic && this->r != n) {
+            throw std::invalid_argument(
+              "permutations: minimal change order is of all the elements");
+        }
+
+        // The permutations that follow a choice of the j-th element: P(n-1-j, r-1-j).
+        if (this->r <= n) {
+            place_values.assign(this->r, 1);
+            total = 1;
+            for (auto j = this->r; j-- > 0;) {
+                place_values[j] = total;
+                if (__builtin_mul_overflow(total, n - j, &total)) {
+                    throw std::length_error("permutations: too many to count");
+                }
+            }
+        }
+    }
+
+    auto begin() { return iterator(this, 0); }
+
+    auto end() { return iterator(this, total); }
+
+    std::size_t size() const { return total; }
+
+  private:
+    std::vector<std::size_t> place_values;
+    std::size_t total = 0;
+};
+
+namespace detail {
+template<permutation_order Order, class Range>
+constexpr auto
+permutations(Range&& range, std::optional<std::size_t> r)
+{
+    return permutations_container<Order, Range>(std::forward<Range>(range), r);
+}
+}
+
+// All orderings of a range's elements.
+template<permutation_order Order = permutation_order::lexicographic, class Range>
+constexpr auto
+permutations(Range&& range)
+{
+    return detail::permutations<Order>(std::forward<Range>(range), std::nullopt);
+}
+
+// The orderings of r of a range's elements.
+template<permutation_order Order = permutation_order::lexicographic, class Range>
+constexpr auto
+permutations(Range&& range, std::size_t r)
+{
+    return detail::permutations<Order>(std::forward<Range>(range), r);
+}
+
+}
+}
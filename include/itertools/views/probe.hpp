@@ -0,0 +1,215 @@
+#include "itertools/profile.hpp"
+#include "itertools/range_iterator.hpp"
+
+#include <string_view>
+
+#pragma once
+
+namespace itertools {
+namespace views {
+
+/*
+Passes a range through unchanged, recording into a profile::stage the elements it
+yields (steps in either direction) and the time and allocations it takes to yield
+them. Only built when
+ITERTOOLS_PROFILE is defined; otherwise views::probe is the identity.
+ */
+template<class Range>
+class probe_container : public std::ranges::view_interface<probe_container<Range>>
+{
+  public:
+    template<class Iter>
+    class iterator : public range_iterator<Iter, iterator<Iter>>
+    {
+        using base_t = range_iterator<Iter, iterator<Iter>>;
+
+      public:
+        using base_t::operator++;
+        using base_t::operator--;
+
+        profile::stage* stage = nullptr;
+
+        iterator() = default;
+
+        iterator(profile::stage* stage, Iter it)
+          : base_t(std::move(it))
+          , stage(stage)
+        {}
+
+        iterator& operator++()
+        {
+            auto n = stage->elements.fetch_add(1, std::memory_order_relaxed);
+            stage->record(n, [this] { ++this->it; });
+            return *this;
+        }
+
+        iterator& operator--()
+        {
+            auto n = stage->elements.fetch_add(1, std::memory_order_relaxed);
+            stage->record(n, [this] { --this->it; });
+            return *this;
+        }
+
+        decltype(auto) operator*() const
+        {
+            auto n = stage->derefs.fetch_add(1, std::memory_order_relaxed);
+            return stage->record(n, [this]() -> decltype(auto) { return *this->it; });
+        }
+
+        friend decltype(auto) iter_move(const iterator& i) noexcept(
+          noexcept(std::ranges::iter_move(i.it)))
+        {
+            return std::ranges::iter_move(i.it);
+        }
+    };
+
+    using iterator_t = iterator<view_iterator_t<Range>>;
+
+    view_t<Range> range;
+    profile::stage* stage;
+
+    probe_container(Range&& range, profile::stage* stage)
+      : range(to_view(std::forward<Range>(range)))
+      , stage(stage)
+    {}
+
+    auto begin()
+    {
+        auto it = stage->record_once([this] { return std::ranges::begin(range); });
+        return iterator_t(stage, std::move(it));
+    }
+
+    auto end()
+    {
+        if constexpr (std::ranges::common_range<view_t<Range>>) {
+            return iterator_t(stage, std::ranges::end(range));
+        } else {
+            return range_sentinel(std::ranges::end(range));
+        }
+    }
+
+    auto size() requires std::ranges::sized_range<view_t<Range>>
+    {
+        return std::ranges::size(range);
+    }
+};
+
+namespace detail {
+
+template<class T>
+constexpr std::string_view
+full_type_name()
+{
+    std::string_view name = __PRETTY_FUNCTION__;
+    auto first = name.find("T = ") + 4;
+    auto last = name.find_first_of(";]", first);
+    return name.substr(first, last - first);
+}
+
+/*
+The unqualified name of T's template, "_container" dropped: "filter" for a
+filter_container<Pred, Range>.
+ */
+template<class T>
+constexpr std::string_view
+stage_name()
+{
+    auto name = full_type_name<T>();
+    name = name.substr(0, name.find('<'));
+    if (auto pos = name.rfind("::"); pos != name.npos) {
+        name.remove_prefix(pos + 2);
+    }
+    if (name.ends_with("_container")) {
+        name.remove_suffix(std::string_view("_container").size());
+    }
+    return name;
+}
+
+// The nearest probed stage a range draws its elements from, if any.
+template<class Range>
+constexpr profile::stage*
+find_stage(Range& range)
+{
+    if constexpr (is_instance<std::remove_cv_t<Range>, probe_container>::value) {
+        return range.stage;
+    } else if constexpr (requires { range.base(); }) {
+        auto&& base = range.base();
+        return find_stage(base);
+    } else if constexpr (requires { range.range; }) {
+        return find_stage(range.range);
+    } else {
+        return nullptr;
+    }
+}
+
+template<class Range>
+constexpr auto
+probe(Range&& range, std::string_view name)
+{
+    auto* upstream = find_stage(range);
+    return probe_container<Range>(std::forward<Range>(range),
+                                  &profile::get_stage(name, upstream));
+}
+
+/*
+Under ITERTOOLS_PROFILE_ALL, operator| passes every stage's source and result through
+these. A source that isn't yet probed is probed under the name of its type; a
+result under that of the pipeline producing it, "vector | filter | transform".
+Results that aren't views, like to<>'s containers, are passed through untouched.
+ */
+template<class Range>
+constexpr decltype(auto)
+probe_source(Range&& range)
+{
+    using range_t = std::remove_cvref_t<Range>;
+
+    if constexpr (is_instance<range_t, probe_container>::value ||
+                  !std::ranges::viewable_range<Range>) {
+        return std::forward<Range>(range);
+    } else {
+        return probe(std::forward<Range>(range), stage_name<range_t>());
+    }
+}
+
+template<class Range>
+constexpr decltype(auto)
+probe_result(Range&& range, const profile::stage* source)
+{
+    using range_t = std::remove_cvref_t<Range>;
+
+    if constexpr (is_instance<range_t, probe_container>::value ||
+                  !std::ranges::view<range_t>) {
+        // By value for an rvalue, which would otherwise dangle.
+        return Range(std::forward<Range>(range));
+    } else {
+        auto name = std::string(stage_name<range_t>());
+        if (source) {
+            name = source->name + " | " + name;
+        }
+        return probe(std::forward<Range>(range), name);
+    }
+}
+
+}
+
+/*
+Records the elements flowing past this point of a pipeline under "name"; see
+profile::report. Compiles to nothing unless ITERTOOLS_PROFILE is defined;
+ITERTOOLS_PROFILE_ALL further probes every stage of every pipeline.
+ */
+constexpr auto
+probe([[maybe_unused]] std::string_view name)
+{
+#ifdef ITERTOOLS_PROFILE
+    return [name]<class Range>(Range&& range) {
+        return detail::probe(std::forward<Range>(range), name);
+    };
+#else
+    return []<class Range>(Range&& range) -> Range {
+        return std::forward<Range>(range);
+    };
+#endif
+}
+
+}
+}
@@ -0,0 +1,265 @@
+#include "itertools/range_iterator.hpp"
+#include "itertools/tupletools.hpp"
+#include "itertools/views/zip.hpp"
+
+#include <array>
+#include <tuple>
+#include <utility>
+
+#pragma once
+
+namespace itertools {
+namespace views {
+
+/*
+The Cartesian product of ranges, as tuples of references: (a, x), (a, y), (b, x) ...
+for [a, b] and [x, y]. An iterator advances like an odometer, its last range
+fastest, carrying into the one before as each wraps around; amortized O(1) a step.
+
+When every range is sized and random access (iotas, vectors), so is the product: an
+iterator also keeps its position as one number, which operator+= unranks into each
+range's position in O(N), so that a product can be split into blocks, or among
+threads, like any other random access range.
+ */
+template<class... Ranges>
+class product_container
+  : public std::ranges::view_interface<product_container<Ranges...>>
+{
+    static_assert(sizeof...(Ranges) > 0);
+    static_assert((std::ranges::forward_range<view_t<Ranges>> && ...),
+                  "product ranges must be forward ranges");
+
+    static constexpr std::size_t N = sizeof...(Ranges);
+
+  public:
+    using begin_t = std::tuple<view_iterator_t<Ranges>...>;
+    using end_t = std::tuple<view_sentinel_t<Ranges>...>;
+
+    static constexpr bool is_indexed =
+      ((std::ranges::random_access_range<view_t<Ranges>> &&
+        std::ranges::sized_range<view_t<Ranges>>)&&...);
+
+    // Wrapping a range around backwards starts from its end.
+    static constexpr bool is_bidirectional =
+      ((std::ranges::bidirectional_range<view_t<Ranges>> &&
+        std::ranges::common_range<view_t<Ranges>>)&&...);
+
+    class iterator : public range_iterator<begin_t, iterator>
+    {
+        using base_t = range_iterator<begin_t, iterator>;
+
+      public:
+        using iterator_concept = std::conditional_t<
+          is_indexed,
+          std::random_access_iterator_tag,
+          std::conditional_t<is_bidirectional,
+                             std::bidirectional_iterator_tag,
+                             std::forward_iterator_tag>>;
+
+        using value_type =
+          std::invoke_result_t<decltype(detail::tuple_deref), const begin_t&>;
+        using difference_type = std::ptrdiff_t;
+
+        using base_t::operator++;
+        using base_t::operator--;
+        using base_t::operator-;
+
+        product_container* base = nullptr;
+        // The position, counted from begin; only kept if is_indexed.
+        difference_type index = 0;
+
+        iterator() = default;
+
+        iterator(product_container* base, begin_t its, difference_type index = 0)
+          : base_t(std::move(its))
+          , base(base)
+          , index(index)
+        {}
+
+        iterator& operator++()
+        {
+            if constexpr (is_indexed) {
+                ++index;
+            }
+            increment<N - 1>();
+            return *this;
+        }
+
+        iterator& operator--() requires is_bidirectional
+        {
+            if constexpr (is_indexed) {
+                --index;
+            }
+            decrement<N - 1>();
+            return *this;
+        }
+
+        iterator& operator+=(difference_type n) requires is_indexed
+        {
+            index += n;
+            if (base->total > 0) {
+                unrank<N - 1>(index);
+            }
+            return *this;
+        }
+
+        difference_type operator-(const iterator& rhs) const requires is_indexed
+        {
+            return index - rhs.index;
+        }
+
+        auto operator<=>(const iterator& rhs) const requires is_indexed
+        {
+            return index <=> rhs.index;
+        }
+
+        bool operator==(const iterator& rhs) const
+        {
+            if constexpr (is_indexed) {
+                return index == rhs.index;
+            } else {
+                return this->it == rhs.it;
+            }
+        }
+
+        bool operator==(std::default_sentinel_t) const
+        {
+            return std::get<0>(this->it) == std::get<0>(base->ends);
+        }
+
+        decltype(auto) operator*() const { return detail::tuple_deref(this->it); }
+
+      private:
+        template<std::size_t I>
+        void increment()
+        {
+            auto& it = std::get<I>(this->it);
+            ++it;
+            if constexpr (I > 0) {
+                if (it == std::get<I>(base->ends)) {
+                    it = std::get<I>(base->begins);
+                    increment<I - 1>();
+                }
+            }
+        }
+
+        template<std::size_t I>
+        void decrement()
+        {
+            auto& it = std::get<I>(this->it);
+            if constexpr (I > 0) {
+                if (it == std::get<I>(base->begins)) {
+                    it = std::get<I>(base->ends);
+                    decrement<I - 1>();
+                }
+            }
+            --it;
+        }
+
+        // Splits "i" into each range's position, the first taking what remains.
+        template<std::size_t I>
+        void unrank(difference_type i)
+        {
+            if constexpr (I == 0) {
+                std::get<0>(this->it) = std::get<0>(base->begins) + i;
+            } else {
+                auto n = base->sizes[I];
+                std::get<I>(this->it) = std::get<I>(base->begins) + i % n;
+                unrank<I - 1>(i / n);
+            }
+        }
+    };
+
+    std::tuple<view_t<Ranges>...> ranges;
+
+    product_container(Ranges&&... ranges)
+      : ranges(to_view(std::forward<Ranges>(ranges))...)
+    {}
+
+    auto begin()
+    {
+        bound();
+        auto its = begins;
+        // Nothing to pair the first range's elements with: begin is end.
+        if (total == 0) {
+            std::get<0>(its) = first_end();
+        }
+        return iterator(this, std::move(its));
+    }
+
+    auto end()
+    {
+        bound();
+        using first_t = std::tuple_element_t<0, std::tuple<view_t<Ranges>...>>;
+        if constexpr (is_indexed || std::ranges::common_range<first_t>) {
+            auto its = begins;
+            std::get<0>(its) = first_end();
+            return iterator(this, std::move(its), total);
+        } else {
+            return std::default_sentinel;
+        }
+    }
+
+    auto size() requires(std::ranges::sized_range<view_t<Ranges>>&&...)
+    {
+        return std::apply(
+          [](auto&... rs) {
+              return (static_cast<std::size_t>(std::ranges::size(rs)) * ...);
+          },
+          ranges);
+    }
+
+  private:
+    /*
+    The ranges' bounds, read afresh by begin() and end(), as a moved product's
+    ranges may be elsewhere.
+     */
+    void bound()
+    {
+        begins =
+          tupletools::transform([](auto& r) { return std::ranges::begin(r); }, ranges);
+        ends =
+          tupletools::transform([](auto& r) { return std::ranges::end(r); }, ranges);
+
+        // Only whether it's empty is needed of a product that isn't indexed.
+        if constexpr (is_indexed) {
+            total = 1;
+            [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                ((sizes[Is] = static_cast<std::ptrdiff_t>(
+                    std::ranges::size(std::get<Is>(ranges))),
+                  total *= sizes[Is]),
+                 ...);
+            }(std::make_index_sequence<N>{});
+        } else {
+            total = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                return ((std::get<Is>(begins) != std::get<Is>(ends)) && ...);
+            }(std::make_index_sequence<N>{});
+        }
+    }
+
+    auto first_end()
+    {
+        auto& first = std::get<0>(ranges);
+        if constexpr (is_indexed) {
+            return std::ranges::begin(first) + sizes[0];
+        } else {
+            return std::ranges::next(std::ranges::begin(first),
+                                     std::ranges::end(first));
+        }
+    }
+
+    begin_t begins;
+    end_t ends;
+    std::array<std::ptrdiff_t, N> sizes{};
+    std::ptrdiff_t total = 0;
+};
+
+template<class... Ranges>
+constexpr auto
+product(Ranges&&... ranges)
+{
+    return product_container<Ranges...>(std::forward<Ranges>(ranges)...);
+}
+
+}
+}
@@ -0,0 +1,256 @@
+#include "itertools/range_iterator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <span>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
+
+#pragma once
+
+namespace itertools {
+namespace views {
+namespace detail {
+
+/*
+Reads a file descriptor on a thread of its own, into a ring of "n" page-aligned
+buffers, so that the next chunk is being read while the current one is processed.
+The consumer holds at most one buffer at a time, handing it back on its next call
+to next(); the reader stays at most n - 1 buffers ahead of it.
+ */
+class chunk_reader
+{
+  public:
+    static constexpr std::size_t alignment = 4096;
+
+    chunk_reader(int fd, std::size_t chunk_size, std::size_t n)
+      : fd(fd)
+      , chunk_size(chunk_size)
+      , sizes(n)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            buffers.emplace_back(static_cast<std::byte*>(
+              ::operator new(chunk_size, std::align_val_t(alignment))));
+        }
+        thread = std::thread([this] { run(); });
+    }
+
+    chunk_reader(const chunk_reader&) = delete;
+    chunk_reader& operator=(const chunk_reader&) = delete;
+
+    ~chunk_reader()
+    {
+        {
+            std::scoped_lock lock(mutex);
+            stop = true;
+        }
+        cv.notify_all();
+        thread.join();
+    }
+
+    /*
+    The next chunk, or nullopt once the descriptor's exhausted. A failed read is
+    rethrown here, as a std::system_error, once the chunks before it are consumed.
+     */
+    std::optional<std::span<const std::byte>> next()
+    {
+        std::unique_lock lock(mutex);
+
+        if (holding) {
+            holding = false;
+            ++released;
+            cv.notify_all();
+        }
+
+        cv.wait(lock, [this] { return consumed < produced || eof || error; });
+
+        if (consumed < produced) {
+            auto i = consumed++ % buffers.size();
+            holding = true;
+            return std::span<const std::byte>(buffers[i].get(), sizes[i]);
+        } else if (error) {
+            throw std::system_error(error, std::generic_category(), "read_chunks");
+        }
+        return std::nullopt;
+    }
+
+  private:
+    struct buffer_delete
+    {
+        void operator()(std::byte* p) const
+        {
+            ::operator delete(p, std::align_val_t(alignment));
+        }
+    };
+
+    // Reads once, polling so that a reader blocked on a quiet pipe still sees "stop".
+    std::ptrdiff_t read_some(std::byte* buffer)
+    {
+        // poll() passes over negative descriptors, rather than flagging them.
+        if (fd < 0) {
+            errno = EBADF;
+            return -1;
+        }
+
+        pollfd pfd{ fd, POLLIN, 0 };
+        while (!stop) {
+            int ready = ::poll(&pfd, 1, 50);
+            if (ready < 0 && errno != EINTR) {
+                return -1;
+            } else if (ready <= 0) {
+                continue;
+            }
+
+            auto n = ::read(fd, buffer, chunk_size);
+            if (n >= 0 || (errno != EINTR && errno != EAGAIN)) {
+                return n;
+            }
+        }
+        return 0;
+    }
+
+    void run()
+    {
+        for (;;) {
+            std::byte* buffer;
+            {
+                std::unique_lock lock(mutex);
+                cv.wait(lock, [this] {
+                    return stop || produced - released < buffers.size();
+                });
+                if (stop) {
+                    return;
+                }
+                buffer = buffers[produced % buffers.size()].get();
+            }
+
+            auto n = read_some(buffer);
+            auto err = n < 0 ? errno : 0;
+
+            {
+                std::scoped_lock lock(mutex);
+                if (n > 0) {
+                    sizes[produced++ % buffers.size()] = static_cast<std::size_t>(n);
+                } else {
+                    eof = true;
+                    error = err;
+                }
+            }
+            cv.notify_all();
+
+            if (n <= 0) {
+                return;
+            }
+        }
+    }
+
+    int fd;
+    std::size_t chunk_size;
+
+    std::vector<std::unique_ptr<std::byte, buffer_delete>> buffers;
+    std::vector<std::size_t> sizes;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+
+    // Buffers filled by the reader, taken by the consumer, and handed back by it.
+    std::size_t produced = 0;
+    std::size_t consumed = 0;
+    std::size_t released = 0;
+
+    bool holding = false;
+    bool eof = false;
+    int error = 0;
+    std::atomic<bool> stop = false;
+
+    std::thread thread;
+};
+
+}
+
+/*
+The contents of a file descriptor, read ahead on a background thread, as a single
+pass range of std::span<const std::byte> chunks. Each span is valid until the
+next increment. The descriptor isn't owned, and must outlive the view.
+
+Reading starts with the first call to begin(). Compose with views::lines or
+views::split to cut the chunks into pieces regardless of where they fall.
+ */
+class read_chunks_container
+  : public std::ranges::view_interface<read_chunks_container>
+{
+  public:
+    class iterator
+    {
+      public:
+        using value_type = std::span<const std::byte>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::input_iterator_tag;
+
+        iterator() = default;
+
+        explicit iterator(read_chunks_container* base)
+          : base(base)
+        {}
+
+        value_type operator*() const { return *base->current; }
+
+        iterator& operator++()
+        {
+            base->current = base->reader->next();
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const { return !base->current; }
+
+      private:
+        read_chunks_container* base = nullptr;
+    };
+
+    read_chunks_container(int fd, std::size_t chunk_size, std::size_t buffers)
+      : fd(fd)
+      , chunk_size(std::max<std::size_t>(chunk_size, 1))
+      , buffers(std::max<std::size_t>(buffers, 2))
+    {}
+
+    iterator begin()
+    {
+        if (!reader) {
+            reader = std::make_unique<detail::chunk_reader>(fd, chunk_size, buffers);
+            current = reader->next();
+        }
+        return iterator(this);
+    }
+
+    std::default_sentinel_t end() const { return std::default_sentinel; }
+
+  private:
+    int fd;
+    std::size_t chunk_size;
+    std::size_t buffers;
+
+    std::unique_ptr<detail::chunk_reader> reader;
+    std::optional<std::span<const std::byte>> current;
+};
+
+inline auto
+read_chunks(int fd, std::size_t chunk_size = 1 << 20, std::size_t buffers = 2)
+{
+    return read_chunks_container(fd, chunk_size, buffers);
+}
+
+}
+}
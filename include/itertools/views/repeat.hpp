@@ -0,0 +1,157 @@
+#include "itertools/range_iterator.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+#pragma once
+
+namespace itertools {
+namespace views {
+
+/*
+One value, over and over: Python's itertools.repeat. Without a count it never ends,
+its end being std::unreachable_sentinel; with one, it's a sized, random access range
+of that many references to the value, which the view keeps.
+
+A bounded repeat fed to to<Container>() is written by the container's own
+assign(n, value): a memset, for bytes, rather than n push_backs.
+ */
+template<class T, bool Bounded>
+class repeat_container
+  : public std::ranges::view_interface<repeat_container<T, Bounded>>
+{
+  public:
+    class iterator
+    {
+      public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::random_access_iterator_tag;
+
+        iterator() = default;
+
+        constexpr iterator(const T* value, difference_type n)
+          : value(value)
+          , n(n)
+        {}
+
+        constexpr iterator& operator++()
+        {
+            ++n;
+            return *this;
+        }
+
+        constexpr iterator& operator--()
+        {
+            --n;
+            return *this;
+        }
+
+        constexpr iterator operator++(int)
+        {
+            auto tmp = *this;
+            ++n;
+            return tmp;
+        }
+
+        constexpr iterator operator--(int)
+        {
+            auto tmp = *this;
+            --n;
+            return tmp;
+        }
+
+        constexpr iterator& operator+=(difference_type i)
+        {
+            n += i;
+            return *this;
+        }
+
+        constexpr iterator& operator-=(difference_type i)
+        {
+            n -= i;
+            return *this;
+        }
+
+        constexpr iterator operator+(difference_type i) const
+        {
+            return iterator(value, n + i);
+        }
+
+        constexpr iterator operator-(difference_type i) const
+        {
+            return iterator(value, n - i);
+        }
+
+        friend constexpr iterator operator+(difference_type i, const iterator& rhs)
+        {
+            return rhs + i;
+        }
+
+        constexpr difference_type operator-(const iterator& rhs) const
+        {
+            return n - rhs.n;
+        }
+
+        constexpr bool operator==(const iterator& rhs) const { return n == rhs.n; }
+
+        constexpr auto operator<=>(const iterator& rhs) const { return n <=> rhs.n; }
+
+        constexpr const T& operator*() const { return *value; }
+
+        constexpr const T& operator[](difference_type) const { return *value; }
+
+      private:
+        const T* value = nullptr;
+        difference_type n = 0;
+    };
+
+    T value;
+    std::size_t times = 0;
+
+    constexpr repeat_container(T value, std::size_t times = 0)
+      : value(std::move(value))
+      , times(times)
+    {}
+
+    constexpr auto begin() const { return iterator(&value, 0); }
+
+    constexpr auto end() const
+    {
+        if constexpr (Bounded) {
+            return iterator(&value, static_cast<std::ptrdiff_t>(times));
+        } else {
+            return std::unreachable_sentinel;
+        }
+    }
+
+    constexpr std::size_t size() const requires Bounded { return times; }
+
+    // For to<Container>(): the whole repeat, at once.
+    template<class Container>
+    void assign_to(Container& container) const
+      requires Bounded && requires { container.assign(times, value); }
+    {
+        container.assign(times, value);
+    }
+};
+
+// A value, without end.
+template<class T>
+constexpr auto
+repeat(T value)
+{
+    return repeat_container<T, false>(std::move(value));
+}
+
+// A value, n times.
+template<class T>
+constexpr auto
+repeat(T value, std::size_t n)
+{
+    return repeat_container<T, true>(std::move(value), n);
+}
+
+}
+}
@@ -8,64 +8,131 @@ namespace itertools {
 namespace views {
 namespace detail {
 
+/*
+Iterates a bidirectional range back to front. Like std::reverse_iterator, each
+iterator holds the position one past the element it refers to.
+ */
 template<class Range>
 class reverse_container
+  : public cached_container<Range,
+                            view_iterator_t<Range>,
+                            view_iterator_t<Range>>
+  , public std::ranges::view_interface<reverse_container<Range>>
 {
   public:
     template<class Iter>
-    class iterator : public range_iterator<Iter>
+    class iterator : public range_iterator<Iter, iterator<Iter>>
     {
+        using base_t = range_iterator<Iter, iterator<Iter>>;
+
       public:
-        constexpr iterator(Iter&& it)
-          : range_iterator<Iter>(std::forward<Iter>(it))
+        using base_t::operator++;
+        using base_t::operator--;
+        using base_t::operator-;
+
+        iterator() = default;
+
+        constexpr iterator(Iter it)
+          : base_t(std::move(it))
         {}
 
-        decltype(auto) operator*()
-        {
-            auto tmp = *--this->it;
-            this->it = ++this->it;
-            return tmp;
-        }
+        constexpr decltype(auto) operator*() const { return *std::ranges::prev(this->it); }
 
-        decltype(auto) operator++()
+        constexpr iterator& operator++()
         {
             --this->it;
             return *this;
         }
 
-        decltype(auto) operator--()
+        constexpr iterator& operator--()
         {
             ++this->it;
             return *this;
         }
-    };
 
-    template<class Iter>
-    iterator(Iter&&) -> iterator<Iter>;
+        constexpr iterator& operator+=(typename base_t::difference_type n)
+        {
+            this->it -= n;
+            return *this;
+        }
+
+        constexpr std::weak_ordering operator<=>(const iterator& rhs) const
+          requires std::random_access_iterator<Iter>
+        {
+            return rhs.base_t::operator<=>(*this);
+        }
 
-    Range range;
+        constexpr auto operator-(const iterator& rhs) const
+          requires std::sized_sentinel_for<Iter, Iter>
+        {
+            return rhs.it - this->it;
+        }
+
+        friend constexpr decltype(auto) iter_move(const iterator& i)
+        {
+            return std::ranges::iter_move(std::ranges::prev(i.it));
+        }
+    };
+
+    using iterator_t = iterator<view_iterator_t<Range>>;
 
     constexpr reverse_container(Range&& range)
-      : range(std::forward<Range>(range))
+      : cached_container<Range, view_iterator_t<Range>, view_iterator_t<Range>>(
+          std::forward<Range>(range))
     {}
 
-    auto begin() { return iterator(std::end(range)); }
+    // A non-common range's end is found by walking to it, once.
+    void init_begin() override
+    {
+        this->begin_ =
+          std::ranges::next(std::ranges::begin(this->range), std::ranges::end(this->range));
+    }
+
+    void init_end() override { this->end_ = std::ranges::begin(this->range); }
+
+    auto begin()
+    {
+        if constexpr (std::ranges::common_range<view_t<Range>>) {
+            return iterator_t(std::ranges::end(this->range));
+        } else {
+            return iterator_t(this->cache_begin());
+        }
+    }
+
+    auto end() { return iterator_t(std::ranges::begin(this->range)); }
 
-    auto end() { return iterator(std::begin(range)); }
+    auto size() requires std::ranges::sized_range<view_t<Range>>
+    {
+        return std::ranges::size(this->range);
+    }
 };
 
 template<class Range>
 reverse_container(Range&&) -> reverse_container<Range>;
 
+/*
+Reversing a reverse cancels out: the inner reverse's range is returned as is.
+ */
+template<class Range>
+constexpr auto
+reverse(Range&& range)
+{
+    if constexpr (is_instance<std::remove_cvref_t<Range>, reverse_container>::value) {
+        return std::forward<Range>(range).range;
+    } else {
+        return reverse_container<Range>(std::forward<Range>(range));
+    }
+}
+
 }
 
 constexpr auto
 reverse()
 {
     return []<class Range>(Range&& range) {
-        return detail::reverse_container<Range>(std::forward<Range>(range));
+        return detail::reverse(std::forward<Range>(range));
     };
 }
 
 }
-}
\ No newline at end of file
+}
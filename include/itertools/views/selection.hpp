@@ -0,0 +1,99 @@
+#include "itertools/range_iterator.hpp"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#pragma once
+
+namespace itertools {
+namespace views {
+
+/*
+The elements of a random access range at a list of positions, as references: what
+permutations and combinations yield. The positions are borrowed from the iterator
+that yielded the selection, and are only good until it's advanced; copy the
+selection (to<std::vector>(), say) to keep it.
+ */
+template<class Iter>
+class selection : public std::ranges::view_interface<selection<Iter>>
+{
+  public:
+    class iterator : public range_iterator<const std::size_t*, iterator>
+    {
+        using base_t = range_iterator<const std::size_t*, iterator>;
+
+      public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using value_type = std::iter_value_t<Iter>;
+        using difference_type = std::ptrdiff_t;
+
+        using base_t::operator++;
+        using base_t::operator--;
+        using base_t::operator-;
+
+        Iter first{};
+
+        iterator() = default;
+
+        iterator(const std::size_t* it, Iter first)
+          : base_t(it)
+          , first(std::move(first))
+        {}
+
+        decltype(auto) operator*() const
+        {
+            return first[static_cast<std::iter_difference_t<Iter>>(*this->it)];
+        }
+    };
+
+    selection() = default;
+
+    selection(Iter first, std::span<const std::size_t> positions)
+      : first(std::move(first))
+      , positions(positions)
+    {}
+
+    auto begin() const { return iterator(positions.data(), first); }
+
+    auto end() const { return iterator(positions.data() + positions.size(), first); }
+
+    std::size_t size() const { return positions.size(); }
+
+    // The selected positions, ascending for a combination.
+    std::span<const std::size_t> indices() const { return positions; }
+
+  private:
+    Iter first{};
+    std::span<const std::size_t> positions;
+};
+
+namespace detail {
+
+/*
+A range that can be indexed: a random access range as it is, and anything else
+copied into a std::vector, once.
+ */
+template<class Range>
+constexpr auto
+indexable(Range&& range)
+{
+    if constexpr (std::ranges::random_access_range<view_t<Range>> &&
+                  std::ranges::sized_range<view_t<Range>>) {
+        return to_view(std::forward<Range>(range));
+    } else {
+        std::vector<std::ranges::range_value_t<Range>> values;
+        for (auto&& x : range) {
+            values.push_back(std::forward<decltype(x)>(x));
+        }
+        return to_view(std::move(values));
+    }
+}
+
+template<class Range>
+using indexable_t = decltype(indexable(std::declval<Range>()));
+
+}
+
+}
+}
@@ -1,25 +1,189 @@
 #include <itertools/views/filter.hpp>
+#include <itertools/views/iota.hpp>
 
 #pragma once
 
 namespace itertools { namespace views {
 
 namespace detail {
+/*
+Ranges without end: those whose end is std::unreachable_sentinel, as count's, and
+those that say so, as an unbounded cycle, whose end is a std::default_sentinel that
+only an empty cycle's iterators reach.
+ */
+template<class Range>
+concept Unbounded =
+  std::same_as<std::ranges::sentinel_t<Range>, std::unreachable_sentinel_t> ||
+  requires { requires std::remove_cvref_t<Range>::is_unbounded; };
+}
+
+/*
+The elements of a range in [start, stop). Both bounds are found once, on first use,
+by stepping no further than the range's end; for a random access range that is
+constant time, and the slice keeps the range's iterator category. An unbounded
+random access range, such as count or cycle, has its bounds jumped to directly.
+ */
+template<class Range>
+class slice_container
+  : public cached_container<Range, view_iterator_t<Range>, view_iterator_t<Range>>
+  , public std::ranges::view_interface<slice_container<Range>>
+{
+  public:
+    using cached_t =
+      cached_container<Range, view_iterator_t<Range>, view_iterator_t<Range>>;
+
+    size_t start, stop;
+
+    slice_container(Range&& range, size_t start, size_t stop)
+      : cached_t(std::forward<Range>(range))
+      , start(start)
+      , stop(std::max(start, stop))
+    {}
+
+    static constexpr bool is_unbounded = detail::Unbounded<view_t<Range>>;
+
+    void init_begin() override
+    {
+        auto first = std::ranges::begin(this->range);
+        auto n = static_cast<std::ptrdiff_t>(start);
+        if constexpr (is_unbounded) {
+            this->begin_ = std::ranges::next(first, n);
+        } else {
+            this->begin_ = std::ranges::next(first, n, std::ranges::end(this->range));
+        }
+    }
+
+    void init_end() override
+    {
+        auto n = std::min(stop - start,
+                          static_cast<size_t>(std::numeric_limits<std::ptrdiff_t>::max()));
+        auto count = static_cast<std::ptrdiff_t>(n);
+        if constexpr (is_unbounded) {
+            this->end_ = std::ranges::next(*this->begin_, count);
+        } else {
+            this->end_ =
+              std::ranges::next(*this->begin_, count, std::ranges::end(this->range));
+        }
+    }
+
+    auto begin() { return range_iterator(this->cache_begin()); }
+
+    auto end() { return range_iterator(this->cache_end()); }
+
+    auto size() requires std::sized_sentinel_for<view_iterator_t<Range>,
+                                                 view_iterator_t<Range>>
+    {
+        return static_cast<size_t>(this->cache_end() - this->cache_begin());
+    }
+};
+
+template<class Range>
+slice_container(Range&&, size_t, size_t) -> slice_container<Range>;
+
+/*
+A slice of an input range, which can only be read once, so whose end can't be found
+ahead of time: begin() skips to start, and the iterator counts down what's left, not
+advancing past the last, so that nothing beyond stop is read.
+ */
+template<class Range>
+class input_slice_container
+  : public std::ranges::view_interface<input_slice_container<Range>>
+{
+    using iter_t = view_iterator_t<Range>;
+
+  public:
+    class iterator
+    {
+      public:
+        using value_type = std::iter_value_t<iter_t>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::input_iterator_tag;
+
+        iterator() = default;
+
+        iterator(input_slice_container* base, iter_t it, std::ptrdiff_t left)
+          : base(base)
+          , it(std::move(it))
+          , left(left)
+        {}
+
+        decltype(auto) operator*() const { return *it; }
+
+        iterator& operator++()
+        {
+            if (--left > 0) {
+                ++it;
+            }
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const
+        {
+            return left <= 0 || it == std::ranges::end(base->range);
+        }
+
+      private:
+        input_slice_container* base = nullptr;
+        iter_t it{};
+        std::ptrdiff_t left = 0;
+    };
+
+    view_t<Range> range;
+    size_t start, stop;
+
+    input_slice_container(Range&& range, size_t start, size_t stop)
+      : range(to_view(std::forward<Range>(range)))
+      , start(start)
+      , stop(std::max(start, stop))
+    {}
+
+    auto begin()
+    {
+        auto it = std::ranges::begin(range);
+        std::ranges::advance(
+          it, static_cast<std::ptrdiff_t>(start), std::ranges::end(range));
+        auto max = static_cast<size_t>(std::numeric_limits<std::ptrdiff_t>::max());
+        auto n = static_cast<std::ptrdiff_t>(std::min(stop - start, max));
+        return iterator(this, std::move(it), n);
+    }
+
+    auto end() { return std::default_sentinel; }
+};
+
+namespace detail {
+/*
+A slice of an integral iota is itself an iota, whose bounds are narrowed to the
+slice's.
+ */
 template<class Range>
 constexpr auto
 slice(Range&& range, size_t start = 0, size_t stop = std::numeric_limits<size_t>::max())
 {
-    auto pred = [=, pos = 0UL](auto&&) mutable {
-        auto b = (pos >= start and pos <= stop);
-        pos += 1;
+    using range_t = std::remove_cvref_t<Range>;
 
-        return b;
-    };
-    return filter(std::move(pred), std::forward<Range>(range));
+    if constexpr (is_instance<range_t, iota>::value &&
+                  std::is_integral_v<std::ranges::range_value_t<range_t>>) {
+        using T = std::ranges::range_value_t<range_t>;
+
+        auto size = range.size();
+        start = std::min(start, size);
+        stop = std::clamp(stop, start, size);
+
+        auto first = range.start + static_cast<T>(start) * range.stride;
+        auto last = first + static_cast<T>(stop - start) * range.stride;
+
+        return range_t(first, last, range.stride);
+    } else if constexpr (!std::ranges::forward_range<view_t<Range>>) {
+        return input_slice_container<Range>(std::forward<Range>(range), start, stop);
+    } else {
+        return slice_container<Range>(std::forward<Range>(range), start, stop);
+    }
 };
 }
 
-auto
+constexpr auto
 slice(size_t start = 0, size_t stop = std::numeric_limits<size_t>::max())
 {
     return [=]<class Range>(Range&& range) {
@@ -27,4 +191,4 @@ slice(size_t start = 0, size_t stop = std::numeric_limits<size_t>::max())
     };
 }
 
-}}
\ No newline at end of file
+}}
@@ -0,0 +1,192 @@
+#include "itertools/views/mmap.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#pragma once
+
+namespace itertools {
+namespace views {
+namespace detail {
+
+/*
+A snapshot file is a header, a descriptor per column, and then the columns, each
+"rows" values laid end to end, aligned to snapshot_alignment. Values are in the
+writer's own byte order, which the header records; a reader of another refuses the
+file, as it would one of another version.
+ */
+struct snapshot_header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t rows;
+    std::uint32_t columns;
+    std::uint32_t reserved;
+};
+
+struct snapshot_column_info
+{
+    std::uint64_t offset;
+    std::uint32_t size;
+    std::uint32_t kind;
+};
+
+inline constexpr char snapshot_magic[8] = { 'i', 't', 's', 'n', 'a', 'p', 0, 0 };
+inline constexpr std::uint32_t snapshot_version = 1;
+inline constexpr std::uint32_t snapshot_byte_order = 0x01020304;
+inline constexpr std::size_t snapshot_alignment = 64;
+
+// What a column holds, along with its size, so that a mistyped read is caught.
+enum class snapshot_kind : std::uint32_t
+{
+    record,
+    signed_integer,
+    unsigned_integer,
+    floating_point
+};
+
+template<class T>
+constexpr std::uint32_t
+snapshot_kind_of()
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        return std::uint32_t(snapshot_kind::floating_point);
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        return std::uint32_t(snapshot_kind::signed_integer);
+    } else if constexpr (std::is_integral_v<T>) {
+        return std::uint32_t(snapshot_kind::unsigned_integer);
+    } else {
+        return std::uint32_t(snapshot_kind::record);
+    }
+}
+
+template<class T>
+constexpr snapshot_column_info
+snapshot_column_of(std::uint64_t offset)
+{
+    return { offset, sizeof(T), snapshot_kind_of<T>() };
+}
+
+constexpr std::uint64_t
+snapshot_align(std::uint64_t offset)
+{
+    return (offset + snapshot_alignment - 1) / snapshot_alignment * snapshot_alignment;
+}
+
+// The header and column descriptors of a snapshot of "rows" values of each T.
+template<class... T>
+struct snapshot_layout
+{
+    snapshot_header header;
+    std::array<snapshot_column_info, sizeof...(T)> columns;
+
+    constexpr explicit snapshot_layout(std::uint64_t rows)
+      : header{ {}, snapshot_version, snapshot_byte_order, rows, sizeof...(T), 0 }
+    {
+        std::copy(std::begin(snapshot_magic), std::end(snapshot_magic), header.magic);
+
+        auto offset = data_offset();
+        std::size_t i = 0;
+        ((columns[i++] = snapshot_column_of<T>(offset),
+          offset = snapshot_align(offset + rows * sizeof(T))),
+         ...);
+    }
+
+    static constexpr std::uint64_t data_offset()
+    {
+        return snapshot_align(sizeof(snapshot_header) +
+                              sizeof...(T) * sizeof(snapshot_column_info));
+    }
+};
+
+/*
+The number of rows of a mapped snapshot of T's, after checking that it is one: its
+version, byte order, and each column's type and extent. Anything amiss throws
+std::invalid_argument.
+ */
+template<class... T>
+std::uint64_t
+check_snapshot(const mapped_file& file,
+               const std::filesystem::path& path,
+               std::array<snapshot_column_info, sizeof...(T)>& columns)
+{
+    auto fail = [&](const char* what) {
+        throw std::invalid_argument("snapshot: " + path.string() + ": " + what);
+    };
+
+    snapshot_header header;
+    if (file.size() < sizeof header + sizeof columns) {
+        fail("too short");
+    }
+    std::memcpy(&header, file.data(), sizeof header);
+    std::memcpy(columns.data(), file.data() + sizeof header, sizeof columns);
+
+    if (std::memcmp(header.magic, snapshot_magic, sizeof header.magic) != 0) {
+        fail("not a snapshot");
+    } else if (header.version != snapshot_version) {
+        fail("unsupported version");
+    } else if (header.byte_order != snapshot_byte_order) {
+        fail("written with another byte order");
+    } else if (header.columns != sizeof...(T)) {
+        fail("wrong number of columns");
+    }
+
+    auto expected = snapshot_layout<T...>(header.rows).columns;
+    for (std::size_t i = 0; i < sizeof...(T); ++i) {
+        if (columns[i].size != expected[i].size ||
+            columns[i].kind != expected[i].kind) {
+            fail("column of the wrong type");
+        }
+        if (columns[i].offset != expected[i].offset ||
+            columns[i].offset + header.rows * columns[i].size > file.size()) {
+            fail("truncated or corrupt column");
+        }
+    }
+    return header.rows;
+}
+
+}
+
+/*
+Maps a snapshot written by to_snapshot, returning its columns as contiguous ranges
+straight into the mapping: one, for a single T, or a std::tuple of them. Nothing is
+copied or parsed; columns share the mapping, which lives as long as any of them.
+
+    auto [ids, scores] = views::from_snapshot<int, double>("scores.snap");
+ */
+template<class... T>
+auto
+from_snapshot(const std::filesystem::path& path, access how = access::sequential)
+{
+    static_assert(sizeof...(T) > 0);
+    static_assert((std::is_trivially_copyable_v<T> && ...),
+                  "snapshot columns must be trivially copyable");
+
+    auto file = std::make_shared<const detail::mapped_file>(path, how);
+
+    std::array<detail::snapshot_column_info, sizeof...(T)> columns;
+    auto rows = detail::check_snapshot<T...>(*file, path, columns);
+
+    auto ret = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        return std::tuple{ mmap_container<T>(file, columns[Is].offset, rows)... };
+    }(std::index_sequence_for<T...>{});
+
+    if constexpr (sizeof...(T) == 1) {
+        return std::get<0>(std::move(ret));
+    } else {
+        return ret;
+    }
+}
+
+}
+}
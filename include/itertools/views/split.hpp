@@ -0,0 +1,326 @@
+#include "itertools/range_iterator.hpp"
+
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#pragma once
+
+namespace itertools {
+namespace views {
+namespace detail {
+
+/*
+The first occurrence of "c" in [first, last), or last. Scans 32 bytes at a time
+when built with AVX2, and otherwise defers to memchr, itself vectorized by most
+C libraries.
+ */
+inline const char*
+find_byte(const char* first, const char* last, char c)
+{
+#ifdef __AVX2__
+    auto needle = _mm256_set1_epi8(c);
+    for (; last - first >= 32; first += 32) {
+        auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        auto mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle));
+        if (mask != 0) {
+            return first + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+    }
+#endif
+    if (first == last) {
+        return last;
+    }
+    auto p = std::memchr(first, c, static_cast<std::size_t>(last - first));
+    return p ? static_cast<const char*>(p) : last;
+}
+
+template<class Range>
+concept ByteRange = std::ranges::contiguous_range<Range> &&
+  std::ranges::sized_range<Range> && sizeof(std::ranges::range_value_t<Range>) == 1;
+
+// A range of byte ranges, like views::read_chunks, each valid until the next.
+template<class Range>
+concept ChunkRange = std::ranges::input_range<Range> &&
+  ByteRange<std::ranges::range_reference_t<Range>> &&
+  std::ranges::borrowed_range<std::ranges::range_reference_t<Range>>;
+
+}
+
+/*
+The pieces of a contiguous range of bytes (chars, std::bytes, ...) between each
+occurrence of a delimiter, as std::string_views into the range; nothing is copied.
+
+As with Python's str.split, n delimiters make n + 1 pieces, empty or not. In
+"lines" mode, a trailing '\r' is dropped from each piece, and a final, trailing
+newline doesn't begin another, empty, line.
+ */
+template<class Range>
+class split_container : public std::ranges::view_interface<split_container<Range>>
+{
+  public:
+    class iterator
+    {
+      public:
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::forward_iterator_tag;
+
+        iterator() = default;
+
+        iterator(const split_container* base, const char* first, const char* end)
+          : base(base)
+          , first(first)
+          , end(end)
+        {
+            if (base->is_lines && first == end) {
+                done = true;
+            } else {
+                last = detail::find_byte(first, end, base->delim);
+            }
+        }
+
+        std::string_view operator*() const
+        {
+            auto n = static_cast<std::size_t>(last - first);
+            if (base->is_lines && n > 0 && first[n - 1] == '\r') {
+                --n;
+            }
+            return { first, n };
+        }
+
+        iterator& operator++()
+        {
+            if (last == end || (base->is_lines && last + 1 == end)) {
+                done = true;
+            } else {
+                first = last + 1;
+                last = detail::find_byte(first, end, base->delim);
+            }
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const iterator& rhs) const
+        {
+            return done == rhs.done && (done || first == rhs.first);
+        }
+
+        bool operator==(std::default_sentinel_t) const { return done; }
+
+      private:
+        const split_container* base = nullptr;
+        const char* first = nullptr;
+        const char* last = nullptr;
+        const char* end = nullptr;
+        bool done = false;
+    };
+
+    view_t<Range> range;
+    char delim;
+    bool is_lines;
+
+    split_container(Range&& range, char delim, bool is_lines = false)
+      : range(to_view(std::forward<Range>(range)))
+      , delim(delim)
+      , is_lines(is_lines)
+    {}
+
+    auto begin()
+    {
+        auto first = reinterpret_cast<const char*>(std::ranges::data(range));
+        return iterator(this, first, first + std::ranges::size(range));
+    }
+
+    auto end() { return std::default_sentinel; }
+};
+
+template<class Range>
+split_container(Range&&, char, bool) -> split_container<Range>;
+
+/*
+split_container over a range of chunks, read as their concatenation: a single pass
+range of the same pieces, whichever chunks they span. A piece lying within a chunk
+is a view into it; one spanning several is gathered into a buffer, reused from piece
+to piece. Either is valid until the next increment.
+ */
+template<class Range>
+class chunked_split_container
+  : public std::ranges::view_interface<chunked_split_container<Range>>
+{
+  public:
+    class iterator
+    {
+      public:
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::input_iterator_tag;
+
+        iterator() = default;
+
+        explicit iterator(chunked_split_container* base)
+          : base(base)
+        {}
+
+        std::string_view operator*() const { return base->piece; }
+
+        iterator& operator++()
+        {
+            base->advance();
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const { return base->done; }
+
+      private:
+        chunked_split_container* base = nullptr;
+    };
+
+    view_t<Range> range;
+    char delim;
+    bool is_lines;
+
+    chunked_split_container(Range&& range, char delim, bool is_lines = false)
+      : range(to_view(std::forward<Range>(range)))
+      , delim(delim)
+      , is_lines(is_lines)
+    {}
+
+    auto begin()
+    {
+        if (!chunk) {
+            chunk = std::ranges::begin(range);
+            if (load()) {
+                advance();
+            } else {
+                finish();
+            }
+        }
+        return iterator(this);
+    }
+
+    auto end() { return std::default_sentinel; }
+
+  private:
+    // Points first and last at the current chunk, if there's one left.
+    bool load()
+    {
+        if (*chunk == std::ranges::end(range)) {
+            return false;
+        }
+        auto&& bytes = **chunk;
+        first = reinterpret_cast<const char*>(std::ranges::data(bytes));
+        last = first + std::ranges::size(bytes);
+        return true;
+    }
+
+    void set_piece(const char* piece_first, const char* piece_last)
+    {
+        if (carry.empty()) {
+            piece = { piece_first, static_cast<std::size_t>(piece_last - piece_first) };
+        } else {
+            carry.append(piece_first, piece_last);
+            piece = carry;
+        }
+        if (is_lines && piece.ends_with('\r')) {
+            piece.remove_suffix(1);
+        }
+    }
+
+    void advance()
+    {
+        // The last piece may have been the carry's.
+        carry.clear();
+
+        if (exhausted) {
+            done = true;
+            return;
+        }
+
+        for (;;) {
+            if (auto p = detail::find_byte(first, last, delim); p != last) {
+                set_piece(first, p);
+                first = p + 1;
+                return;
+            }
+
+            // The chunk's tail begins a piece that the next chunk continues.
+            carry.append(first, last);
+            ++*chunk;
+
+            if (!load()) {
+                finish();
+                return;
+            }
+        }
+    }
+
+    // Whatever's carried is the last piece, unless it's an empty line.
+    void finish()
+    {
+        exhausted = true;
+        if (is_lines && carry.empty()) {
+            done = true;
+        } else {
+            set_piece(last, last);
+        }
+    }
+
+    std::optional<std::ranges::iterator_t<view_t<Range>>> chunk;
+    const char* first = nullptr;
+    const char* last = nullptr;
+
+    std::string carry;
+    std::string_view piece;
+
+    bool exhausted = false;
+    bool done = false;
+};
+
+namespace detail {
+template<ByteRange Range>
+constexpr auto
+split(Range&& range, char delim, bool is_lines = false)
+{
+    return split_container<Range>(std::forward<Range>(range), delim, is_lines);
+};
+
+template<ChunkRange Range>
+constexpr auto
+split(Range&& range, char delim, bool is_lines = false)
+{
+    return chunked_split_container<Range>(std::forward<Range>(range), delim, is_lines);
+};
+}
+
+constexpr auto
+split(char delim)
+{
+    return [=]<class Range>(Range&& range) {
+        return detail::split(std::forward<Range>(range), delim);
+    };
+}
+
+constexpr auto
+lines()
+{
+    return []<class Range>(Range&& range) {
+        return detail::split(std::forward<Range>(range), '\n', true);
+    };
+}
+
+}
+}
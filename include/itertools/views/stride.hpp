@@ -5,27 +5,123 @@
 namespace itertools {
 namespace views {
 
-namespace detail {
-
+/*
+Every stride-th element of a range, starting with the first. As with block, an
+iterator remembers by how much its last step overshot the range's end ("missing"),
+so that the end can be stepped back from.
+ */
 template<class Range>
-decltype(auto)
-stride(Range&& range, size_t stride = 1)
+class stride_container : public std::ranges::view_interface<stride_container<Range>>
 {
-    auto pred = [=, pos = 0UL](auto&&) mutable {
-        auto b = pos % stride == 0;
+  public:
+    template<class Iter>
+    class iterator : public range_iterator<Iter, iterator<Iter>>
+    {
+        using base_t = range_iterator<Iter, iterator<Iter>>;
+
+        constexpr auto end_of() const { return std::ranges::end(base->range); }
+
+      public:
+        using difference_type = typename base_t::difference_type;
+
+        using base_t::operator++;
+        using base_t::operator--;
+        using base_t::operator-;
+
+        stride_container* base = nullptr;
+        difference_type missing = 0;
+
+        iterator() = default;
 
-        if (b && pos == stride) {
-            pos = 0;
+        iterator(stride_container* base, Iter it, difference_type missing = 0)
+          : base_t(std::move(it))
+          , base(base)
+          , missing(missing)
+        {}
+
+        iterator& operator++()
+        {
+            missing = std::ranges::advance(this->it, base->stride, end_of());
+            return *this;
+        }
+
+        iterator& operator--()
+        {
+            std::ranges::advance(this->it, missing - base->stride);
+            missing = 0;
+            return *this;
+        }
+
+        iterator& operator+=(difference_type n)
+        {
+            if (n > 0) {
+                missing = std::ranges::advance(this->it, base->stride * n, end_of());
+            } else if (n < 0) {
+                std::ranges::advance(this->it, base->stride * n + missing);
+                missing = 0;
+            }
+            return *this;
         }
 
-        pos += 1;
-        return b;
+        difference_type operator-(const iterator& rhs) const
+          requires std::sized_sentinel_for<Iter, Iter>
+        {
+            return (this->it - rhs.it + missing - rhs.missing) / base->stride;
+        }
+
+        friend constexpr decltype(auto) iter_move(const iterator& i) noexcept(
+          noexcept(std::ranges::iter_move(i.it)))
+        {
+            return std::ranges::iter_move(i.it);
+        }
     };
-    return filter(std::move(pred), std::forward<Range>(range));
+
+    using iterator_t = iterator<view_iterator_t<Range>>;
+
+    view_t<Range> range;
+    std::ptrdiff_t stride;
+
+    stride_container(Range&& range, size_t stride)
+      : range{ to_view(std::forward<Range>(range)) }
+      , stride(static_cast<std::ptrdiff_t>(std::max<size_t>(stride, 1)))
+    {}
+
+    auto begin() { return iterator_t(this, std::ranges::begin(range)); }
+
+    auto end()
+    {
+        if constexpr (std::ranges::common_range<view_t<Range>> &&
+                      std::ranges::sized_range<view_t<Range>>) {
+            auto size = std::ranges::distance(range);
+            auto missing = (stride - size % stride) % stride;
+            return iterator_t(this, std::ranges::end(range), missing);
+        } else {
+            return range_sentinel(std::ranges::end(range));
+        }
+    }
+
+    auto size() requires std::ranges::sized_range<view_t<Range>>
+    {
+        auto size = std::ranges::size(range);
+        auto n = static_cast<size_t>(stride);
+        return (size + n - 1) / n;
+    }
+};
+
+template<class Range>
+stride_container(Range&&, size_t) -> stride_container<Range>;
+
+namespace detail {
+
+template<class Range>
+decltype(auto)
+stride(Range&& range, size_t stride = 1)
+{
+    return stride_container<Range>(std::forward<Range>(range), stride);
 };
 }
 
-auto
+constexpr auto
 stride(size_t stride = 1)
 {
     return [=]<class Range>(Range&& range) {
@@ -34,4 +130,4 @@ stride(size_t stride = 1)
 }
 
 }
-}
\ No newline at end of file
+}
@@ -0,0 +1,78 @@
+#include "itertools/range_iterator.hpp"
+
+#include <functional>
+#include <utility>
+
+#pragma once
+
+namespace itertools {
+namespace views {
+
+/*
+A range's elements up to the first for which pred fails: Python's
+itertools.takewhile. The end is a sentinel that tests pred, so iteration stops the
+first time it fails, and nothing past that element's read: over a file, a count or a
+cycle, that's what bounds the scan. The iterators are the range's own, with its
+category; like std::views::take_while, an element's dereferenced once for pred and
+once more for the loop.
+ */
+template<class Pred, class Range>
+class take_while_container
+  : public std::ranges::view_interface<take_while_container<Pred, Range>>
+{
+    using iter_t = view_iterator_t<Range>;
+
+  public:
+    class sentinel
+    {
+      public:
+        sentinel() = default;
+
+        explicit sentinel(take_while_container* base)
+          : base(base)
+        {}
+
+        friend bool operator==(const range_iterator<iter_t>& lhs, const sentinel& rhs)
+        {
+            return lhs.it == std::ranges::end(rhs.base->range) ||
+                   !std::invoke(*rhs.base->pred, *lhs.it);
+        }
+
+      private:
+        take_while_container* base = nullptr;
+    };
+
+    view_t<Range> range;
+    movable_box<Pred> pred;
+
+    take_while_container(Pred&& pred, Range&& range)
+      : range(to_view(std::forward<Range>(range)))
+      , pred(std::forward<Pred>(pred))
+    {}
+
+    auto begin() { return range_iterator<iter_t>(std::ranges::begin(range)); }
+
+    auto end() { return sentinel(this); }
+};
+
+namespace detail {
+template<class Pred, class Range>
+constexpr auto
+take_while(Pred pred, Range&& range)
+{
+    return take_while_container<Pred, Range>(std::move(pred),
+                                             std::forward<Range>(range));
+}
+}
+
+template<class Pred>
+constexpr auto
+take_while(Pred&& pred)
+{
+    return [pred = std::forward<Pred>(pred)]<class Range>(Range&& range) {
+        return detail::take_while(pred, std::forward<Range>(range));
+    };
+}
+
+}
+}
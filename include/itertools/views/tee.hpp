@@ -0,0 +1,288 @@
+#include "itertools/range_iterator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#pragma once
+
+namespace itertools {
+namespace views {
+namespace detail {
+
+/*
+What a tee's branches share: the source range, read once, and a ring of the
+elements read from it that some branch has yet to reach. Positions count elements
+from the start of the range; position p is kept at ring[p & mask]. The ring holds
+[head, tail), tail being how far the fastest branch has read. Its slots are raw
+storage, constructed as they're read; only once it's full are the slots every
+branch has passed destroyed, head moved up to the slowest branch, and, if the
+branches have drifted further apart than that, the ring doubled.
+
+Branches keep their own positions, publishing them with seek(). A concurrent
+state's branches only call take(), which locks; they fetch elements in batches, to
+take the lock rarely.
+ */
+template<class Range, bool Concurrent>
+class tee_state
+{
+  public:
+    using value_type = std::ranges::range_value_t<view_t<Range>>;
+
+    tee_state(Range&& range, std::size_t branches, std::size_t capacity)
+      : range(to_view(std::forward<Range>(range)))
+      , it(std::ranges::begin(this->range))
+      , positions(branches, 0)
+      , mask(std::bit_ceil(std::max<std::size_t>(capacity, 1)) - 1)
+      , ring(alloc.allocate(mask + 1))
+    {}
+
+    tee_state(const tee_state&) = delete;
+    tee_state& operator=(const tee_state&) = delete;
+
+    ~tee_state()
+    {
+        for (; head < tail; ++head) {
+            std::destroy_at(ring + (head & mask));
+        }
+        alloc.deallocate(ring, mask + 1);
+    }
+
+    // Whether there's an element at position p, reading it from the source if need be.
+    bool available(std::size_t p)
+    {
+        if (p < tail) {
+            return true;
+        } else if (it == std::ranges::end(range)) {
+            return false;
+        }
+        read();
+        return true;
+    }
+
+    // Only after available(p).
+    const value_type& get(std::size_t p) const { return ring[p & mask]; }
+
+    std::size_t position(std::size_t branch) const { return positions[branch]; }
+
+    void seek(std::size_t branch, std::size_t p) { positions[branch] = p; }
+
+    // Copies up to n of a branch's elements into "out", advancing it past them.
+    void take(std::size_t branch, std::vector<value_type>& out, std::size_t n)
+    {
+        std::unique_lock<std::mutex> lock;
+        if constexpr (Concurrent) {
+            lock = std::unique_lock(mutex);
+        }
+        out.clear();
+        auto p = positions[branch];
+        for (; out.size() < n && available(p); ++p) {
+            out.push_back(get(p));
+        }
+        positions[branch] = p;
+    }
+
+    // How many elements are read but not yet reached by every branch.
+    std::size_t buffered() const
+    {
+        std::unique_lock<std::mutex> lock;
+        if constexpr (Concurrent) {
+            lock = std::unique_lock(mutex);
+        }
+        return tail - *std::ranges::min_element(positions);
+    }
+
+  private:
+    void read()
+    {
+        if (tail - head == mask + 1) {
+            drop();
+            if (tail - head == mask + 1) {
+                grow();
+            }
+        }
+        std::construct_at(ring + (tail & mask), *it);
+        ++it;
+        ++tail;
+    }
+
+    void grow()
+    {
+        auto larger_mask = mask * 2 + 1;
+        auto larger = alloc.allocate(larger_mask + 1);
+        for (auto p = head; p < tail; ++p) {
+            std::construct_at(larger + (p & larger_mask), std::move(ring[p & mask]));
+            std::destroy_at(ring + (p & mask));
+        }
+        alloc.deallocate(ring, mask + 1);
+        ring = larger;
+        mask = larger_mask;
+    }
+
+    // Frees what every branch has passed.
+    void drop()
+    {
+        auto slowest = *std::ranges::min_element(positions);
+        for (; head < slowest; ++head) {
+            std::destroy_at(ring + (head & mask));
+        }
+    }
+
+    view_t<Range> range;
+    view_iterator_t<Range> it;
+    std::vector<std::size_t> positions;
+    std::size_t head = 0, tail = 0;
+    std::size_t mask;
+    std::allocator<value_type> alloc;
+    value_type* ring;
+    mutable std::mutex mutex;
+};
+
+}
+
+/*
+One branch of a tee: an input range of the source's elements, as read by the
+first branch to reach each. An iterator reads its element when it's begun or
+advanced, never when it's dereferenced or compared, which gives a const reference
+into the shared ring, good until any branch of the tee is next begun or advanced. A
+concurrent branch instead copies its elements, a batch at a time, and its references
+are good until it's advanced itself.
+ */
+template<class Range, bool Concurrent>
+class tee_container
+  : public std::ranges::view_interface<tee_container<Range, Concurrent>>
+{
+    using state_t = detail::tee_state<Range, Concurrent>;
+    using value_t = typename state_t::value_type;
+
+  public:
+    static constexpr std::size_t batch_size = 64;
+
+    class iterator
+    {
+      public:
+        using value_type = value_t;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::input_iterator_tag;
+
+        iterator() = default;
+
+        iterator(state_t* state, std::size_t branch)
+          : state(state)
+          , branch(branch)
+          , p(state->position(branch))
+        {
+            if constexpr (Concurrent) {
+                state->take(branch, batch, batch_size);
+            } else {
+                more = state->available(p);
+            }
+        }
+
+        const value_t& operator*() const
+        {
+            if constexpr (Concurrent) {
+                return batch[i];
+            } else {
+                return state->get(p);
+            }
+        }
+
+        iterator& operator++()
+        {
+            if constexpr (Concurrent) {
+                if (++i == batch.size()) {
+                    state->take(branch, batch, batch_size);
+                    i = 0;
+                }
+            } else {
+                state->seek(branch, ++p);
+                more = state->available(p);
+            }
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const
+        {
+            if constexpr (Concurrent) {
+                return i == batch.size();
+            } else {
+                return !more;
+            }
+        }
+
+      private:
+        state_t* state = nullptr;
+        std::size_t branch = 0;
+        // Where a branch is, or, concurrently, where in its batch.
+        std::size_t p = 0;
+        // Whether the element at p has been read.
+        bool more = false;
+        std::vector<value_t> batch;
+        std::size_t i = 0;
+    };
+
+    tee_container(std::shared_ptr<state_t> state, std::size_t branch)
+      : state(std::move(state))
+      , branch(branch)
+    {}
+
+    auto begin() { return iterator(state.get(), branch); }
+
+    auto end() { return std::default_sentinel; }
+
+    // The elements held for the branches lagging behind.
+    std::size_t buffered() const { return state->buffered(); }
+
+  private:
+    std::shared_ptr<state_t> state;
+    std::size_t branch = 0;
+};
+
+namespace detail {
+template<std::size_t N, bool Concurrent, class Range>
+auto
+tee(Range&& range, std::size_t capacity)
+{
+    static_assert(N > 0);
+    using state_t = tee_state<Range, Concurrent>;
+
+    auto state = std::make_shared<state_t>(std::forward<Range>(range), N, capacity);
+    return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        return std::array{ tee_container<Range, Concurrent>(state, Is)... };
+    }(std::make_index_sequence<N>{});
+}
+}
+
+/*
+N branches over one range, each yielding all of its elements, which are read from
+the range once: Python's itertools.tee. The elements between the slowest branch
+and the fastest are kept in a ring of "capacity" elements, grown as need be; a
+branch that's never read keeps everything.
+
+    auto [counts, totals] = views::tee<2>(rows | views::transform(parse));
+ */
+template<std::size_t N, class Range>
+auto
+tee(Range&& range, std::size_t capacity = 1024)
+{
+    return detail::tee<N, false>(std::forward<Range>(range), capacity);
+}
+
+// As tee, but with branches that may each be read on a thread of their own.
+template<std::size_t N, class Range>
+auto
+concurrent_tee(Range&& range, std::size_t capacity = 1024)
+{
+    return detail::tee<N, true>(std::forward<Range>(range), capacity);
+}
+
+}
+}
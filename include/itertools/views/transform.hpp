@@ -7,48 +7,77 @@ namespace views {
 
 template<class Func, class Range>
 class transform_container
+  : public std::ranges::view_interface<transform_container<Func, Range>>
 {
   public:
     template<class Iter>
-    class iterator : public range_iterator<Iter>
+    class iterator : public range_iterator<Iter, iterator<Iter>>
     {
       public:
-        transform_container* base;
+        using value_type = std::remove_cvref_t<
+          std::invoke_result_t<Func&, std::iter_reference_t<Iter>>>;
 
-        iterator(transform_container* base, Iter&& it)
-          : range_iterator<Iter>(std::forward<Iter>(it))
+        transform_container* base = nullptr;
+
+        iterator() = default;
+
+        iterator(transform_container* base, Iter it)
+          : range_iterator<Iter, iterator<Iter>>(std::move(it))
           , base(base)
         {}
 
-        decltype(auto) operator*() { return std::invoke(base->func, *this->it); }
+        decltype(auto) operator*() const { return std::invoke(*base->func, *this->it); }
     };
 
-    template<class Iter>
-    iterator(transform_container*, Iter&&) -> iterator<Iter>;
+    using iterator_t = iterator<view_iterator_t<Range>>;
 
-    Range range;
-    Func func;
+    view_t<Range> range;
+    movable_box<Func> func;
 
     transform_container(Func&& func, Range&& range)
-      : range(std::forward<Range>(range))
+      : range(to_view(std::forward<Range>(range)))
       , func(std::forward<Func>(func))
     {}
 
-    auto begin() { return iterator(this, std::begin(range)); }
+    auto begin() { return iterator_t(this, std::ranges::begin(range)); }
+
+    auto end()
+    {
+        if constexpr (std::ranges::common_range<view_t<Range>>) {
+            return iterator_t(this, std::ranges::end(range));
+        } else {
+            return range_sentinel(std::ranges::end(range));
+        }
+    }
 
-    auto end() { return iterator(this, std::end(range)); }
+    auto size() requires std::ranges::sized_range<view_t<Range>>
+    {
+        return std::ranges::size(range);
+    }
 };
 
 template<class Func, class Range>
 transform_container(Func&&, Range&&) -> transform_container<Func, Range>;
 
 namespace detail {
+/*
+A transform over a transform is fused into one, over the inner transform's range,
+whose function is the composition of the two.
+ */
 template<class Func, class Range>
-constexpr transform_container<Func, Range>
+constexpr auto
 transform(Func func, Range&& range)
 {
-    return transform_container<Func, Range>(std::move(func),
-                                            std::forward<Range>(range));
+    if constexpr (is_instance<std::remove_cvref_t<Range>, transform_container>::value) {
+        auto composed = [f = *range.func, g = std::move(func)]<class T>(
+                          T&& x) mutable -> decltype(auto) {
+            return std::invoke(g, std::invoke(f, std::forward<T>(x)));
+        };
+        return transform(std::move(composed), std::forward<Range>(range).range);
+    } else {
+        return transform_container<Func, Range>(std::move(func),
+                                                std::forward<Range>(range));
+    }
 };
 }
 
@@ -62,4 +91,4 @@ transform(Func&& func)
 }
 
 }
-}
\ No newline at end of file
+}
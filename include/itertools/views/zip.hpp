@@ -1,6 +1,7 @@
 #include "itertools/range_iterator.hpp"
 #include "itertools/tupletools.hpp"
 
+#include <algorithm>
 #include <tuple>
 
 #pragma once
@@ -30,63 +31,156 @@ using tuple_begin_t =
 template<tupletools::Tupleoid T>
 using tuple_end_t = std::remove_cvref_t<std::invoke_result_t<decltype(tuple_end), T>>;
 
+template<class... Iters>
+using zip_concept_t = std::conditional_t<
+  (std::random_access_iterator<Iters> && ...),
+  std::random_access_iterator_tag,
+  std::conditional_t<
+    (std::bidirectional_iterator<Iters> && ...),
+    std::bidirectional_iterator_tag,
+    std::conditional_t<(std::forward_iterator<Iters> && ...),
+                       std::forward_iterator_tag,
+                       std::input_iterator_tag>>>;
+
 template<class Range>
-class zip_container
+class zip_container;
+
+/*
+When every zipped range is sized and random access, the zip's end is clamped to the
+shortest range, so that end is reachable from begin (and vice versa) by every
+component in lock-step; otherwise iteration stops as soon as any component reaches
+its end.
+ */
+template<class... Ranges>
+class zip_container<std::tuple<Ranges...>>
+  : public std::ranges::view_interface<zip_container<std::tuple<Ranges...>>>
 {
   public:
+    using Range = std::tuple<Ranges...>;
+
+    static constexpr bool is_clamped =
+      ((std::ranges::random_access_range<Ranges> &&
+        std::ranges::sized_range<Ranges>)&&...);
+
     template<class Iter>
-    class iterator : public range_iterator<Iter>
+    class iterator : public range_iterator<Iter, iterator<Iter>>
     {
-        using iterator_type = std::remove_cvref_t<Iter>;
-        using value_type = std::remove_cvref_t<
-          std::invoke_result_t<decltype(tuple_deref), iterator_type>>;
-        using reference_type = value_type&;
+        using base_t = range_iterator<Iter, iterator<Iter>>;
 
       public:
-        iterator(Iter&& it)
-          : range_iterator<Iter>(std::forward<Iter>(it))
+        using value_type = std::invoke_result_t<decltype(tuple_deref), const Iter&>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept =
+          zip_concept_t<std::ranges::iterator_t<Ranges>...>;
+
+        using base_t::operator++;
+        using base_t::operator--;
+        using base_t::operator-;
+
+        iterator() = default;
+
+        constexpr iterator(Iter it)
+          : base_t(std::move(it))
         {}
 
-        bool operator==(const iterator& rhs) const
+        template<class Sent>
+        constexpr bool operator==(const iterator<Sent>& rhs) const
         {
             return tupletools::any_where(
               [](auto&& x, auto&& y) { return x == y; }, this->it, rhs.it);
         }
 
-        decltype(auto) operator++()
+        constexpr std::weak_ordering operator<=>(const iterator& rhs) const
+          requires std::is_same_v<iterator_concept, std::random_access_iterator_tag>
+        {
+            return std::get<0>(this->it) <=> std::get<0>(rhs.it);
+        }
+
+        constexpr iterator& operator++()
         {
             tupletools::for_each(this->it, [](auto&&, auto&& v) { ++v; });
             return *this;
         }
 
-        decltype(auto) operator--()
+        constexpr iterator& operator--()
         {
             tupletools::for_each(this->it, [](auto&&, auto&& v) { --v; });
             return *this;
         }
 
-        decltype(auto) operator*() { return tuple_deref(this->it); }
-    };
+        constexpr iterator& operator+=(difference_type n)
+        {
+            tupletools::for_each(this->it, [n](auto&&, auto&& v) { v += n; });
+            return *this;
+        }
 
-    template<class Iter>
-    iterator(Iter&&) -> iterator<Iter>;
+        constexpr difference_type operator-(const iterator& rhs) const
+          requires std::is_same_v<iterator_concept, std::random_access_iterator_tag>
+        {
+            return std::get<0>(this->it) - std::get<0>(rhs.it);
+        }
+
+        constexpr decltype(auto) operator*() const { return tuple_deref(this->it); }
+    };
 
     using begin_t = tuple_begin_t<Range&>;
     using end_t = tuple_end_t<Range&>;
 
+    // The end of a zip of which some range isn't common: the tuple of their ends.
+    class sentinel
+    {
+      public:
+        end_t end;
+
+        sentinel() = default;
+
+        constexpr explicit sentinel(end_t end)
+          : end(std::move(end))
+        {}
+
+        friend constexpr bool operator==(const iterator<begin_t>& lhs,
+                                         const sentinel& rhs)
+        {
+            return tupletools::any_where(
+              [](auto&& x, auto&& y) { return x == y; }, lhs.it, rhs.end);
+        }
+    };
+
     Range range;
 
     zip_container(Range&& range)
-      : range(std::forward<Range>(range))
+      : range(std::move(range))
     {}
 
-    auto begin() { return iterator(tuple_begin(this->range)); }
+    auto begin() { return iterator<begin_t>(tuple_begin(this->range)); }
+
+    auto end()
+    {
+        if constexpr (is_clamped) {
+            auto n = static_cast<std::ptrdiff_t>(size());
+            return iterator<begin_t>(tupletools::transform(
+              [n](auto&& x) { return std::ranges::next(x.begin(), n); },
+              this->range));
+        } else if constexpr ((std::ranges::common_range<Ranges> && ...)) {
+            return iterator<begin_t>(tuple_end(this->range));
+        } else {
+            return sentinel(tuple_end(this->range));
+        }
+    }
 
-    auto end() { return iterator(tuple_end(this->range)); }
+    auto size() requires(std::ranges::sized_range<Ranges>&&...)
+    {
+        return std::apply(
+          [](auto&&... rs) {
+              return std::min({ static_cast<std::size_t>(std::ranges::size(rs))... });
+          },
+          range);
+    }
 };
 
 template<class Range>
-zip_container(Range&&) -> zip_container<Range>;
+zip_container(Range&&) -> zip_container<std::remove_cvref_t<Range>>;
+
 }
 
 // template<class... Args>
@@ -101,7 +195,7 @@ template<class... Args>
 constexpr decltype(auto)
 zip(Args&&... args)
 {
-    auto tup = std::forward_as_tuple(args...);
+    auto tup = std::tuple<view_t<Args>...>(to_view(std::forward<Args>(args))...);
     return detail::zip_container(std::move(tup));
 }
 
@@ -109,7 +203,7 @@ template<class... Args>
 constexpr decltype(auto)
 zip_copy(Args&&... args)
 {
-    auto tup = std::make_tuple(args...);
+    auto tup = std::make_tuple(to_view(std::remove_cvref_t<Args>(args))...);
     return detail::zip_container(std::move(tup));
 }
 
@@ -117,9 +211,8 @@ template<class... Args>
 constexpr decltype(auto)
 zip_copy_if_rvalue(Args&&... args)
 {
-    auto tup = std::make_tuple(tupletools::copy_if_rvalue(std::forward<Args>(args))...);
-    return detail::zip_container(std::move(tup));
+    return zip(std::forward<Args>(args)...);
 }
 
 }
-}
\ No newline at end of file
+}
@@ -0,0 +1,245 @@
+#include "itertools/range_iterator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#pragma once
+
+namespace itertools {
+namespace views {
+
+/*
+Zips ranges of different lengths, running to the end of the longest: Python's
+itertools.zip_longest. A tuple's element from a range that's run out is the fill
+value, kept in the view, so each is a reference to either the element or the fill
+(their common reference: an lvalue where both are, else a value), and nothing's
+wrapped in a std::optional.
+
+When every range is sized, an iterator counts its position, and iteration has two
+phases: before the shortest range's end, where every element's present and none is
+checked, and after it, where each range is checked against its size. Random access
+ranges are then indexed by that count, so that a loop over the zip compiles to two
+plain loops, vectorized. Otherwise, each range is compared to its end at every step.
+ */
+template<class Fill, class... Ranges>
+class zip_longest_container
+  : public std::ranges::view_interface<zip_longest_container<Fill, Ranges...>>
+{
+    static_assert(sizeof...(Ranges) > 0, "zip_longest needs a range to zip");
+    static_assert(
+      (std::common_reference_with<std::ranges::range_reference_t<view_t<Ranges>>,
+                                  const Fill&> &&
+       ...),
+      "zip_longest's fill must share a common reference with every range's elements");
+
+    using iters_t = std::tuple<view_iterator_t<Ranges>...>;
+
+    static constexpr bool is_sized = (std::ranges::sized_range<view_t<Ranges>> && ...);
+
+    static constexpr bool is_forward =
+      (std::ranges::forward_range<view_t<Ranges>> && ...);
+
+    static constexpr bool is_random_access =
+      is_sized && (std::ranges::random_access_range<view_t<Ranges>> && ...);
+
+  public:
+    using value_type =
+      std::tuple<std::common_reference_t<std::iter_reference_t<view_iterator_t<Ranges>>,
+                                         const Fill&>...>;
+
+    class iterator
+    {
+      public:
+        using value_type = zip_longest_container::value_type;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::
+          conditional_t<is_forward, std::forward_iterator_tag, std::input_iterator_tag>;
+
+        iterator() = default;
+
+        iterator(zip_longest_container* base, iters_t its, std::size_t k)
+          : base(base)
+          , its(std::move(its))
+          , k(k)
+        {}
+
+        value_type operator*() const { return deref(indices{}); }
+
+        iterator& operator++()
+        {
+            advance(indices{});
+            ++k;
+            return *this;
+        }
+
+        void operator++(int) requires(!is_forward) { ++*this; }
+
+        iterator operator++(int) requires is_forward
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        iterator& operator+=(difference_type n) requires is_random_access
+        {
+            k += static_cast<std::size_t>(n);
+            return *this;
+        }
+
+        iterator operator+(difference_type n) const requires is_random_access
+        {
+            auto tmp = *this;
+            tmp += n;
+            return tmp;
+        }
+
+        difference_type operator-(const iterator& rhs) const requires is_sized
+        {
+            return static_cast<difference_type>(k - rhs.k);
+        }
+
+        bool operator==(const iterator& rhs) const
+        {
+            if constexpr (is_sized) {
+                return k == rhs.k;
+            } else {
+                return its == rhs.its;
+            }
+        }
+
+        bool operator==(std::default_sentinel_t) const
+        {
+            // >=, not ==: a loop on k < longest, the compiler splits in two at the
+            // shortest range's end.
+            if constexpr (is_sized) {
+                return k >= base->longest;
+            } else {
+                return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                    return (exhausted<Is>() && ...);
+                }(indices{});
+            }
+        }
+
+      private:
+        using indices = std::index_sequence_for<Ranges...>;
+
+        template<std::size_t I>
+        bool exhausted() const
+        {
+            if constexpr (is_sized) {
+                return k >= base->sizes[I];
+            } else {
+                return std::get<I>(its) == std::ranges::end(std::get<I>(base->ranges));
+            }
+        }
+
+        template<std::size_t I>
+        decltype(auto) element() const
+        {
+            if constexpr (is_random_access) {
+                return std::get<I>(its)[static_cast<difference_type>(k)];
+            } else {
+                return *std::get<I>(its);
+            }
+        }
+
+        template<std::size_t I>
+        std::tuple_element_t<I, value_type> column() const
+        {
+            if (exhausted<I>()) {
+                return base->fill;
+            }
+            return element<I>();
+        }
+
+        template<std::size_t... Is>
+        value_type deref(std::index_sequence<Is...>) const
+        {
+            if constexpr (is_sized) {
+                if (k < base->shortest) {
+                    return value_type(element<Is>()...);
+                }
+            }
+            return value_type(column<Is>()...);
+        }
+
+        template<std::size_t... Is>
+        void advance(std::index_sequence<Is...>)
+        {
+            if constexpr (is_random_access) {
+                return;
+            } else if constexpr (is_sized) {
+                if (k < base->shortest) {
+                    (++std::get<Is>(its), ...);
+                    return;
+                }
+            }
+            ((exhausted<Is>() ? void() : void(++std::get<Is>(its))), ...);
+        }
+
+        zip_longest_container* base = nullptr;
+        // The ranges' iterators; random access, their starts.
+        iters_t its{};
+        // How many steps from the start, counted only when every range is sized.
+        std::size_t k = 0;
+    };
+
+    Fill fill;
+    std::tuple<view_t<Ranges>...> ranges;
+
+    zip_longest_container(Fill fill, Ranges&&... ranges)
+      : fill(std::move(fill))
+      , ranges(to_view(std::forward<Ranges>(ranges))...)
+    {
+        if constexpr (is_sized) {
+            sizes = std::apply(
+              [](auto&... rs) {
+                  using std::ranges::size;
+                  return std::array{ static_cast<std::size_t>(size(rs))... };
+              },
+              this->ranges);
+            shortest = *std::ranges::min_element(sizes);
+            longest = *std::ranges::max_element(sizes);
+        }
+    }
+
+    auto begin() { return iterator(this, std::apply(begins, ranges), 0); }
+
+    auto end()
+    {
+        return std::default_sentinel;
+    }
+
+    std::size_t size() const requires is_sized { return longest; }
+
+  private:
+    static constexpr auto begins = [](auto&... rs) {
+        return iters_t(std::ranges::begin(rs)...);
+    };
+
+    std::array<std::size_t, sizeof...(Ranges)> sizes{};
+    std::size_t shortest = 0, longest = 0;
+};
+
+/*
+Zips ranges to the end of the longest, filling in for those that run out first.
+
+    for (auto [t, a, b] : views::zip_longest(nan, times, series_a, series_b)) {
+        // ...
+    }
+ */
+template<class Fill, class... Ranges>
+constexpr auto
+zip_longest(Fill fill, Ranges&&... ranges)
+{
+    return zip_longest_container<Fill, Ranges...>(std::move(fill),
+                                                  std::forward<Ranges>(ranges)...);
+}
+
+}
+}
@@ -0,0 +1,122 @@
+#include <cassert>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "itertools/algorithm/all.hpp"
+#include "itertools/profile.hpp"
+#include "itertools/views/all.hpp"
+
+/*
+Built twice: with ITERTOOLS_PROFILE, where only explicit probes record, and with
+ITERTOOLS_PROFILE_ALL, where every stage does.
+ */
+
+ITERTOOLS_COUNT_ALLOCATIONS()
+
+using namespace itertools;
+
+const profile::stage&
+find(std::string_view name)
+{
+    return profile::get_stage(name);
+}
+
+template<class Range>
+long
+sum(Range&& range)
+{
+    long total = 0;
+    for (auto&& x : range) {
+        total += x;
+    }
+    return total;
+}
+
+auto is_even = [](int x) { return x % 2 == 0; };
+auto add_one = [](int x) { return x + 1; };
+
+void
+test_probe()
+{
+    std::vector<int> v(1000);
+    std::iota(v.begin(), v.end(), 0);
+
+    profile::reset();
+
+    auto rng = v | views::probe("source") | views::filter(is_even) |
+               views::probe("evens") | views::transform(add_one) |
+               views::probe("out");
+
+    assert(sum(rng) == 250000);
+
+    auto& source = find("source");
+    auto& evens = find("evens");
+    auto& out = find("out");
+
+    assert(source.elements == 1000);
+    assert(evens.elements == 500);
+    assert(out.elements == 500);
+
+    assert(source.upstream == nullptr);
+    assert(evens.upstream == &source);
+    assert(out.upstream == &evens);
+    assert(evens.elements_in() == 1000);
+
+    auto blocks = v | views::block(10) | views::probe("blocks");
+    for (auto&& block : blocks) {
+        assert(block.size() == 10);
+    }
+
+    assert(find("blocks").elements == 100);
+    assert(find("blocks").allocs >= 100);
+    assert(out.allocs == 0);
+
+    auto table = profile::report();
+    auto json = profile::report_json();
+
+    assert(table.find("evens") != std::string::npos);
+    assert(json.find("{ \"stage\": \"evens\", \"upstream\": \"source\", \"in\": 1000, "
+                     "\"out\": 500, \"selectivity\": 0.5") != std::string::npos);
+
+    std::cout << table << json;
+}
+
+void
+test_probe_all()
+{
+    std::vector<int> v(1000);
+    std::iota(v.begin(), v.end(), 0);
+
+    profile::reset();
+
+    auto rng = v | views::filter(is_even) | views::transform(add_one);
+
+    assert(sum(rng) == 250000);
+
+    assert(find("vector").elements == 1000);
+    assert(find("vector | filter").elements == 500);
+    assert(find("vector | filter | transform").elements == 500);
+    assert(find("vector | filter | transform").upstream == &find("vector | filter"));
+
+    auto out = v | views::transform(add_one) | to<std::vector>();
+
+    static_assert(std::same_as<decltype(out), std::vector<int>>);
+    assert(out.size() == 1000);
+
+    std::cout << profile::report();
+}
+
+int
+main()
+{
+#ifdef ITERTOOLS_PROFILE_ALL
+    test_probe_all();
+#else
+    test_probe();
+#endif
+
+    std::cout << "profile tests complete" << std::endl;
+    return 0;
+}